@@ -51,7 +51,7 @@ int main(void) {
     gt_render_all_widgets(window);
     gt_refresh_window(window);
     
-    // Wait for user input
+    // Wait for user input, changes are redrawn by the frame scheduler
     gt_event_t event;
     printf("\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n");
     printf("Use arrow keys to navigate, ENTER to click, ESC to exit...\n");
@@ -65,18 +65,18 @@ int main(void) {
                     case GT_KEY_UP:
                     case GT_KEY_LEFT:
                         gt_focus_prev_widget(window);
-                        gt_render_all_widgets(window);
-                        gt_refresh_window(window);
                         break;
                     case GT_KEY_DOWN:
                     case GT_KEY_RIGHT:
                         gt_focus_next_widget(window);
-                        gt_render_all_widgets(window);
-                        gt_refresh_window(window);
                         break;
                     case GT_KEY_ENTER:
                         gt_activate_focused_widget(window);
                         break;
+                    default:
+                        // Typing goes to the focused textbox
+                        gt_textbox_handle_key(gt_get_focused_widget(window), event.data.key);
+                        break;
                 }
             }
         }
@@ -49,6 +49,14 @@ typedef enum {
     GT_ATTR_INVISIBLE = 1 << 5
 } gt_attr_t;
 
+// 屏幕单元格, 供 gt_blit_cells() 批量写入
+typedef struct {
+    char ch;
+    uint8_t fg;                     // gt_color_t
+    uint8_t bg;                     // gt_color_t
+    uint8_t attr;                   // gt_attr_t bits
+} gt_cell_t;
+
 // 键盘按键定义
 typedef enum {
     GT_KEY_UNKNOWN = 0,
@@ -63,7 +71,10 @@ typedef enum {
     GT_KEY_RIGHT,
     GT_KEY_F1, GT_KEY_F2, GT_KEY_F3, GT_KEY_F4,
     GT_KEY_F5, GT_KEY_F6, GT_KEY_F7, GT_KEY_F8,
-    GT_KEY_F9, GT_KEY_F10, GT_KEY_F11, GT_KEY_F12
+    GT_KEY_F9, GT_KEY_F10, GT_KEY_F11, GT_KEY_F12,
+    GT_KEY_HOME,
+    GT_KEY_END,
+    GT_KEY_FORWARD_DELETE
 } gt_key_t;
 
 // 鼠标事件类型
@@ -105,13 +116,68 @@ typedef struct {
 typedef enum {
     GT_WIDGET_BUTTON,
     GT_WIDGET_LABEL,
-    GT_WIDGET_TEXTBOX
+    GT_WIDGET_TEXTBOX,
+    GT_WIDGET_CONSOLE,
+    GT_WIDGET_VIEWPORT,
+    GT_WIDGET_CHART,
+    GT_WIDGET_GAUGE
 } gt_widget_type_t;
 
+// 布局节点类型
+typedef enum {
+    GT_LAYOUT_ROW,                  // Children left to right
+    GT_LAYOUT_COLUMN,               // Children top to bottom
+    GT_LAYOUT_STACK,                // Children on top of each other
+    GT_LAYOUT_HSPLIT,               // First child takes a fixed share of the width
+    GT_LAYOUT_VSPLIT,               // First child takes a fixed share of the height
+    GT_LAYOUT_WIDGET                // Leaf, created by gt_layout_add_widget()
+} gt_layout_type_t;
+
+typedef struct gt_layout gt_layout_t;
+
+// 终端上下文: 每个终端一个, 按线程绑定
+typedef struct gt_context gt_context_t;
+
+// 离屏画布
+typedef struct gt_canvas gt_canvas_t;
+
+// 运行时统计
+typedef struct gt_stats {
+    uint64_t frames_rendered;       // Frames that sent at least one cell
+    uint64_t frames_dropped;        // Flushes deferred while the tty was busy
+    uint64_t cells_changed;
+    uint64_t bytes_written;
+    uint64_t write_calls;
+    uint64_t events_received;
+    uint64_t events_coalesced;      // Redraw requests merged into a pending frame
+    uint64_t ipc_messages_sent;
+    uint64_t ipc_bytes_sent;
+    uint64_t ipc_send_errors;
+    uint64_t ipc_messages_coalesced;  // Queued draws replaced by newer ones
+    uint64_t ipc_messages_retried;    // Sent again after delivery failed
+    uint64_t ipc_reconnects;          // Windows replayed to a restarted WM service
+    uint64_t allocations;
+    uint64_t frame_time_p50_ns;
+    uint64_t frame_time_p99_ns;
+    uint64_t frame_time_max_ns;
+    uint64_t input_latency_p50_ns;  // Key read until its frame was written
+    uint64_t input_latency_p99_ns;
+    uint64_t input_latency_max_ns;
+} gt_stats_t;
+
 typedef struct gt_window gt_window_t;
 typedef struct gt_widget gt_widget_t;
 typedef void (*gt_button_callback_t)(gt_widget_t *widget, void *user_data);
 
+// 终端上下文 (一个进程驱动多个终端, 每个线程绑定一个上下文)
+gt_context_t *gt_create_context(int in_fd, int out_fd);
+void gt_destroy_context(gt_context_t *context);
+void gt_bind_context(gt_context_t *context);
+gt_context_t *gt_get_context(void);
+
+// 无终端上下文: 固定大小, 没有输入, 输出写到 out_fd (回放和离线测量用)
+gt_context_t *gt_create_headless_context(int out_fd, int width, int height);
+
 // 初始化和清理
 int gt_init(void);
 void gt_cleanup(void);
@@ -132,11 +198,23 @@ void gt_clear_window(gt_window_t *window);
 void gt_draw_char(gt_window_t *window, int x, int y, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
 void gt_draw_string(gt_window_t *window, int x, int y, const char *str, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
 void gt_draw_border(gt_window_t *window, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
+void gt_fill_rect(gt_window_t *window, int x, int y, int width, int height, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
+void gt_draw_hline(gt_window_t *window, int x, int y, int length, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
+void gt_draw_vline(gt_window_t *window, int x, int y, int length, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
+void gt_blit_cells(gt_window_t *window, int x, int y, int width, int height, const gt_cell_t *cells, size_t stride);
 void gt_refresh_window(gt_window_t *window);
 void gt_refresh_all(void);
 void gt_set_cursor_position(int x, int y);
 void gt_set_cursor_visibility(bool visible);
 
+// 帧调度: 合并重绘请求, 每个帧间隔最多渲染一次
+void gt_set_frame_rate(int fps);
+
+// 并行渲染: 把屏幕分成行带, 在多个线程上比较和编码 (1 为单线程)
+void gt_set_render_threads(int threads);
+void gt_request_frame(void);
+int gt_run_frame(void);
+
 // 控件
 gt_widget_t *gt_create_button(gt_window_t *window, int x, int y, int width, int height, const char *text, gt_button_callback_t callback, void *user_data);
 gt_widget_t *gt_create_label(gt_window_t *window, int x, int y, const char *text, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
@@ -144,14 +222,78 @@ gt_widget_t *gt_create_textbox(gt_window_t *window, int x, int y, int width, int
 void gt_set_widget_text(gt_widget_t *widget, const char *text);
 const char *gt_get_widget_text(gt_widget_t *widget);
 void gt_set_widget_visible(gt_widget_t *widget, bool visible);
+void gt_set_widget_style(gt_widget_t *widget, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
 void gt_destroy_widget(gt_widget_t *widget);
 void gt_set_widget_focus(gt_widget_t *widget);
 void gt_render_all_widgets(gt_window_t *window);
 void gt_focus_next_widget(gt_window_t *window);
 void gt_focus_prev_widget(gt_window_t *window);
 void gt_activate_focused_widget(gt_window_t *window);
+gt_widget_t *gt_get_focused_widget(gt_window_t *window);
+void gt_render_dirty_widgets(gt_window_t *window);
+
+// 文本框编辑 (按键改变了文本或光标时返回 true)
+bool gt_textbox_handle_key(gt_widget_t *textbox, gt_key_t key);
+size_t gt_textbox_get_cursor(gt_widget_t *textbox);
+
+// 控制台控件 (固定内存上限的日志环形缓冲)
+gt_widget_t *gt_create_console(gt_window_t *window, int x, int y, int width, int height, size_t max_bytes);
+void gt_console_append(gt_widget_t *console, const char *text, size_t len);
+void gt_console_append_line(gt_widget_t *console, const char *line);
+void gt_console_clear(gt_widget_t *console);
+void gt_console_set_wrap(gt_widget_t *console, bool wrap);
+void gt_console_set_follow(gt_widget_t *console, bool follow);
+void gt_console_scroll(gt_widget_t *console, int lines);
+size_t gt_console_line_count(gt_widget_t *console);
+
+// 离屏画布与视口 (画布可大于窗口, 滚动只改变视口偏移)
+gt_canvas_t *gt_create_canvas(int width, int height);
+void gt_destroy_canvas(gt_canvas_t *canvas);
+void gt_get_canvas_size(gt_canvas_t *canvas, int *width, int *height);
+void gt_canvas_clear(gt_canvas_t *canvas);
+void gt_canvas_draw_char(gt_canvas_t *canvas, int x, int y, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
+void gt_canvas_draw_string(gt_canvas_t *canvas, int x, int y, const char *str, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
+void gt_canvas_fill_rect(gt_canvas_t *canvas, int x, int y, int width, int height, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
+void gt_present_canvas(gt_window_t *window, int x, int y, int width, int height, gt_canvas_t *canvas, int src_x, int src_y);
+gt_widget_t *gt_create_viewport(gt_window_t *window, int x, int y, int width, int height, gt_canvas_t *canvas);
+void gt_viewport_scroll_to(gt_widget_t *viewport, int x, int y);
+void gt_viewport_scroll(gt_widget_t *viewport, int dx, int dy);
+void gt_viewport_get_offset(gt_widget_t *viewport, int *x, int *y);
+// 视图按键 (视图滚动了时返回 true)
+bool gt_viewport_handle_key(gt_widget_t *viewport, gt_key_t key);
+
+// 图表与迷你图 (样本存入固定大小的环形缓冲, 按列取最小/最大值; 追加样本只重绘移动的列; NaN 与无穷大被忽略)
+gt_widget_t *gt_create_chart(gt_window_t *window, int x, int y, int width, int height, size_t capacity);
+gt_widget_t *gt_create_sparkline(gt_window_t *window, int x, int y, int width, size_t capacity);
+void gt_chart_push(gt_widget_t *chart, double value);
+void gt_chart_set_range(gt_widget_t *chart, double min, double max);
+void gt_chart_clear(gt_widget_t *chart);
+size_t gt_chart_sample_count(gt_widget_t *chart);
+
+// 进度条 (可在任意线程设置; 只有显示的图案变化时才重绘, 其他线程的更新会唤醒 gt_wait_event())
+gt_widget_t *gt_create_gauge(gt_window_t *window, int x, int y, int width);
+void gt_gauge_set_value(gt_widget_t *gauge, double fraction);
+double gt_gauge_get_value(gt_widget_t *gauge);
+void gt_gauge_set_percent(gt_widget_t *gauge, bool show);
+
+// 布局容器 (弹性布局, 只重排变化的子树)
+gt_layout_t *gt_create_layout(gt_layout_type_t type);
+gt_layout_t *gt_layout_add_widget(gt_layout_t *parent, gt_widget_t *widget);
+int gt_layout_add_child(gt_layout_t *parent, gt_layout_t *child);
+void gt_destroy_layout(gt_layout_t *node);
+void gt_layout_set_flex(gt_layout_t *node, int grow, int basis);
+void gt_layout_set_size_hint(gt_layout_t *node, int width, int height);
+void gt_layout_set_min_size(gt_layout_t *node, int width, int height);
+void gt_layout_set_max_size(gt_layout_t *node, int width, int height);
+void gt_layout_set_padding(gt_layout_t *node, int padding);
+void gt_layout_set_gap(gt_layout_t *node, int gap);
+void gt_layout_set_split(gt_layout_t *node, int per_mille);
+void gt_get_layout_geometry(gt_layout_t *node, int *x, int *y, int *width, int *height);
+void gt_set_window_layout(gt_window_t *window, gt_layout_t *root);
 
 // 事件处理
+// gt_wait_event: timeout 为毫秒 (-1 一直等待); 返回 0 表示读到一个事件,
+// 1 表示超时前没有事件 (event 未填写), -1 表示出错
 int gt_wait_event(gt_event_t *event, int timeout);
 int gt_init_mouse(void);
 void gt_enable_mouse(bool enable);
@@ -159,4 +301,24 @@ uint32_t gt_set_timer(int interval);
 void gt_cancel_timer(uint32_t timer_id);
 const char *gt_get_version(void);
 
+// 性能计数器
+void gt_get_stats(gt_stats_t *stats);
+void gt_reset_stats(void);
+
+// 输入到显示延迟 (按键解码到其帧写完)
+uint64_t gt_get_input_latency(double percentile);
+void gt_set_latency_overlay(bool show);
+
+// 录制每一帧和触发它的事件 (增量编码, 后台线程写盘), 用 tools/gtreplay 回放
+int gt_start_recording(const char *path);
+void gt_stop_recording(void);
+
+// 通过 Unix 套接字共享屏幕, 多个查看者用 tools/gtview 连接; viewer_input 时最早连接的查看者可以输入
+int gt_start_sharing(const char *socket_path, bool viewer_input);
+void gt_stop_sharing(void);
+int gt_get_viewer_count(void);
+
+// 帧时间线追踪 (需要以 TRACE=1 编译), 导出为 Chrome trace JSON
+int gt_trace_dump(const char *path);
+
 #endif
\ No newline at end of file
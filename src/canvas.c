@@ -0,0 +1,270 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Off-screen canvases and viewports. A canvas is a cell array of any
+ * size that applications draw into once; a viewport widget shows a
+ * window-sized part of it. Scrolling only changes the viewport offset,
+ * the visible rows are then blitted again and the screen diff sends
+ * what actually changed.
+ *
+ * Every change to a canvas bumps its generation, so viewports notice
+ * edits without the canvas having to know who shows it. Only the first
+ * change after the canvas was presented requests a frame; the rest are
+ * drawn by that same frame.
+ */
+
+struct gt_canvas {
+    gt_cell_t *cells;
+    int width, height;
+    uint64_t generation;
+    bool frame_requested;       // changed since last presented
+};
+
+struct gt_viewport {
+    gt_canvas_t *canvas;
+    int offset_x, offset_y;
+    uint64_t generation;        // canvas generation last presented
+};
+
+static const gt_cell_t canvas_blank = { ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+
+static void canvas_changed(gt_canvas_t *canvas) {
+    canvas->generation++;
+    if (canvas->frame_requested) return;
+    canvas->frame_requested = true;
+    gt_request_frame();
+}
+
+gt_canvas_t *gt_create_canvas(int width, int height) {
+    if (width <= 0 || height <= 0) return NULL;
+
+    gt_canvas_t *canvas = gt_malloc(sizeof(gt_canvas_t));
+    gt_cell_t *cells = gt_malloc((size_t)width * (size_t)height * sizeof(gt_cell_t));
+    if (!canvas || !cells) {
+        free(canvas);
+        free(cells);
+        return NULL;
+    }
+
+    canvas->cells = cells;
+    canvas->width = width;
+    canvas->height = height;
+    canvas->generation = 0;
+    canvas->frame_requested = false;
+    gt_canvas_clear(canvas);
+    return canvas;
+}
+
+// Viewports showing the canvas must be destroyed first
+void gt_destroy_canvas(gt_canvas_t *canvas) {
+    if (!canvas) return;
+    free(canvas->cells);
+    free(canvas);
+}
+
+void gt_get_canvas_size(gt_canvas_t *canvas, int *width, int *height) {
+    if (!canvas) return;
+    if (width) *width = canvas->width;
+    if (height) *height = canvas->height;
+}
+
+void gt_canvas_clear(gt_canvas_t *canvas) {
+    if (!canvas) return;
+
+    size_t count = (size_t)canvas->width * (size_t)canvas->height;
+    for (size_t i = 0; i < count; i++) canvas->cells[i] = canvas_blank;
+    canvas_changed(canvas);
+}
+
+void gt_canvas_fill_rect(gt_canvas_t *canvas, int x, int y, int width, int height, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+    if (!canvas) return;
+
+    if (x < 0) { width += x; x = 0; }
+    if (y < 0) { height += y; y = 0; }
+    if (x + width > canvas->width) width = canvas->width - x;
+    if (y + height > canvas->height) height = canvas->height - y;
+    if (width <= 0 || height <= 0) return;
+
+    gt_cell_t cell = { ch, (uint8_t)fg, (uint8_t)bg, (uint8_t)attr };
+    for (int row = y; row < y + height; row++) {
+        gt_cell_t *dst = &canvas->cells[(size_t)row * (size_t)canvas->width + (size_t)x];
+        for (int i = 0; i < width; i++) dst[i] = cell;
+    }
+    canvas_changed(canvas);
+}
+
+void gt_canvas_draw_char(gt_canvas_t *canvas, int x, int y, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+    gt_canvas_fill_rect(canvas, x, y, 1, 1, ch, fg, bg, attr);
+}
+
+void gt_canvas_draw_string(gt_canvas_t *canvas, int x, int y, const char *str, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+    if (!canvas || !str || y < 0 || y >= canvas->height) return;
+
+    gt_cell_t *row = &canvas->cells[(size_t)y * (size_t)canvas->width];
+    for (int i = 0; str[i] && x + i < canvas->width; i++) {
+        if (x + i < 0) continue;
+        row[x + i].ch = str[i];
+        row[x + i].fg = (uint8_t)fg;
+        row[x + i].bg = (uint8_t)bg;
+        row[x + i].attr = (uint8_t)attr;
+    }
+    canvas_changed(canvas);
+}
+
+// Show the canvas area at (src_x, src_y) in a window rectangle; the
+// part that falls outside the canvas is blank
+void gt_present_canvas(gt_window_t *window, int x, int y, int width, int height,
+                       gt_canvas_t *canvas, int src_x, int src_y) {
+    if (!window || !canvas || width <= 0 || height <= 0) return;
+    canvas->frame_requested = false;
+
+    // Columns c0..c1 and rows r0..r1 of the rectangle are inside the canvas
+    int c0 = src_x < 0 ? -src_x : 0;
+    int r0 = src_y < 0 ? -src_y : 0;
+    int c1 = canvas->width - src_x < width ? canvas->width - src_x : width;
+    int r1 = canvas->height - src_y < height ? canvas->height - src_y : height;
+    if (c1 <= c0 || r1 <= r0) {
+        gt_fill_rect(window, x, y, width, height, ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+        return;
+    }
+
+    const gt_cell_t *src = &canvas->cells[(size_t)(src_y + r0) * (size_t)canvas->width + (size_t)(src_x + c0)];
+    gt_blit_cells(window, x + c0, y + r0, c1 - c0, r1 - r0, src, (size_t)canvas->width);
+
+    gt_fill_rect(window, x, y, width, r0, ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    gt_fill_rect(window, x, y + r1, width, height - r1, ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    gt_fill_rect(window, x, y + r0, c0, r1 - r0, ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    gt_fill_rect(window, x + c1, y + r0, width - c1, r1 - r0, ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+}
+
+static struct gt_viewport *viewport_of(gt_widget_t *widget) {
+    if (!widget || widget->type != GT_WIDGET_VIEWPORT) return NULL;
+    return widget->ext.viewport;
+}
+
+gt_widget_t *gt_create_viewport(gt_window_t *window, int x, int y, int width, int height, gt_canvas_t *canvas) {
+    if (!window || !canvas || width <= 0 || height <= 0) return NULL;
+
+    gt_widget_t *widget = gt_malloc(sizeof(gt_widget_t));
+    struct gt_viewport *view = gt_malloc(sizeof(struct gt_viewport));
+    if (!widget || !view) {
+        free(widget);
+        free(view);
+        return NULL;
+    }
+
+    view->canvas = canvas;
+    view->offset_x = view->offset_y = 0;
+    view->generation = canvas->generation;
+
+    widget->type = GT_WIDGET_VIEWPORT;
+    widget->x = x;
+    widget->y = y;
+    widget->width = width;
+    widget->height = height;
+    widget->text = NULL;
+    widget->style = gt_style_intern(GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    widget->visible = true;
+    widget->focused = false;
+    gt_invalidate_widget(widget);
+    widget->callback = NULL;
+    widget->user_data = NULL;
+    widget->ext.viewport = view;
+    widget->layout = NULL;
+    widget->next = window->widgets;
+    window->widgets = widget;
+
+    return widget;
+}
+
+// Offsets stop where the canvas edge meets the viewport edge
+void gt_viewport_scroll_to(gt_widget_t *widget, int x, int y) {
+    struct gt_viewport *view = viewport_of(widget);
+    if (!view) return;
+
+    int max_x = view->canvas->width - widget->width;
+    int max_y = view->canvas->height - widget->height;
+    if (x > max_x) x = max_x;
+    if (y > max_y) y = max_y;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x == view->offset_x && y == view->offset_y) return;
+
+    view->offset_x = x;
+    view->offset_y = y;
+    gt_invalidate_widget(widget);
+}
+
+void gt_viewport_scroll(gt_widget_t *widget, int dx, int dy) {
+    struct gt_viewport *view = viewport_of(widget);
+    if (!view) return;
+    gt_viewport_scroll_to(widget, view->offset_x + dx, view->offset_y + dy);
+}
+
+void gt_viewport_get_offset(gt_widget_t *widget, int *x, int *y) {
+    struct gt_viewport *view = viewport_of(widget);
+    if (!view) return;
+    if (x) *x = view->offset_x;
+    if (y) *y = view->offset_y;
+}
+
+// True if the key scrolled the view
+bool gt_viewport_handle_key(gt_widget_t *widget, gt_key_t key) {
+    struct gt_viewport *view = viewport_of(widget);
+    if (!view) return false;
+
+    int x = view->offset_x, y = view->offset_y;
+    switch (key) {
+        case GT_KEY_UP:    gt_viewport_scroll(widget, 0, -1); break;
+        case GT_KEY_DOWN:  gt_viewport_scroll(widget, 0, 1); break;
+        case GT_KEY_LEFT:  gt_viewport_scroll(widget, -1, 0); break;
+        case GT_KEY_RIGHT: gt_viewport_scroll(widget, 1, 0); break;
+        case GT_KEY_HOME:  gt_viewport_scroll_to(widget, 0, 0); break;
+        case GT_KEY_END:   gt_viewport_scroll_to(widget, view->offset_x, view->canvas->height); break;
+        default:
+            return false;
+    }
+    return view->offset_x != x || view->offset_y != y;
+}
+
+void gt_viewport_render(gt_window_t *window, gt_widget_t *widget) {
+    struct gt_viewport *view = viewport_of(widget);
+    if (!view) return;
+
+    gt_present_canvas(window, widget->x, widget->y, widget->width, widget->height,
+                      view->canvas, view->offset_x, view->offset_y);
+    view->generation = view->canvas->generation;
+}
+
+// Repaint a viewport whose canvas was drawn into since it was presented
+void gt_viewport_render_changed(gt_window_t *window, gt_widget_t *widget) {
+    struct gt_viewport *view = viewport_of(widget);
+    if (!view || !widget->visible || view->generation == view->canvas->generation) return;
+    gt_viewport_render(window, widget);
+}
+
+void gt_viewport_destroy(gt_widget_t *widget) {
+    struct gt_viewport *view = viewport_of(widget);
+    if (!view) return;
+    free(view);
+    widget->ext.viewport = NULL;
+}
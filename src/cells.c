@@ -0,0 +1,133 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GT_CELLS_X86
+#endif
+
+/*
+ * Cell row kernels for the frame diff. A cell is four packed bytes, so
+ * rows are compared as 32-bit lanes: 4 cells per SSE2 compare, 8 per
+ * AVX2 compare. The widest kernel the CPU supports is picked once with
+ * cpuid, everything else falls back to 64-bit scalar compares.
+ *
+ * The row hash is the same on every CPU: four independent multiply-xor
+ * lanes over 8-byte words, so the multiplies overlap, folded at the end.
+ */
+
+#define HASH_MUL 0x9e3779b97f4a7c15ull
+
+static size_t mismatch_scalar(const gt_cell_t *a, const gt_cell_t *b, size_t count) {
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        uint64_t wa, wb;
+        memcpy(&wa, &a[i], sizeof(wa));
+        memcpy(&wb, &b[i], sizeof(wb));
+        if (wa != wb) break;
+    }
+    for (; i < count; i++) {
+        if (memcmp(&a[i], &b[i], sizeof(gt_cell_t)) != 0) return i;
+    }
+    return count;
+}
+
+#ifdef GT_CELLS_X86
+__attribute__((target("sse2")))
+static size_t mismatch_sse2(const gt_cell_t *a, const gt_cell_t *b, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i *)&a[i]);
+        __m128i vb = _mm_loadu_si128((const __m128i *)&b[i]);
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi32(va, vb)) ^ 0xffffu;
+        if (mask) return i + (size_t)__builtin_ctz(mask) / 4;
+    }
+    return i + mismatch_scalar(&a[i], &b[i], count - i);
+}
+
+__attribute__((target("avx2")))
+static size_t mismatch_avx2(const gt_cell_t *a, const gt_cell_t *b, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)&a[i]);
+        __m256i vb = _mm256_loadu_si256((const __m256i *)&b[i]);
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi32(va, vb));
+        if (mask) return i + (size_t)__builtin_ctz(mask) / 4;
+    }
+    return i + mismatch_sse2(&a[i], &b[i], count - i);
+}
+#endif
+
+static size_t (*mismatch_kernel)(const gt_cell_t *a, const gt_cell_t *b, size_t count) = mismatch_scalar;
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+
+static void select_kernels(void) {
+#ifdef GT_CELLS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        mismatch_kernel = mismatch_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        mismatch_kernel = mismatch_sse2;
+    }
+#endif
+}
+
+// Called by gt_init(), before any frame is encoded
+void gt_cells_init(void) {
+    pthread_once(&kernels_once, select_kernels);
+}
+
+// Index of the first cell that differs, count if the rows are equal
+size_t gt_cells_mismatch(const gt_cell_t *a, const gt_cell_t *b, size_t count) {
+    return mismatch_kernel(a, b, count);
+}
+
+uint64_t gt_cells_hash(const gt_cell_t *cells, size_t count) {
+    const unsigned char *p = (const unsigned char *)cells;
+    size_t len = count * sizeof(gt_cell_t);
+    uint64_t lane[4] = { HASH_MUL, HASH_MUL ^ 1, HASH_MUL ^ 2, HASH_MUL ^ 3 };
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        for (int k = 0; k < 4; k++) {
+            uint64_t word;
+            memcpy(&word, p + i + 8 * k, sizeof(word));
+            lane[k] = (lane[k] ^ word) * HASH_MUL;
+        }
+    }
+    for (int k = 0; i + 8 <= len; i += 8, k++) {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        lane[k] = (lane[k] ^ word) * HASH_MUL;
+    }
+    if (i < len) {
+        uint32_t word;
+        memcpy(&word, p + i, sizeof(word));
+        lane[3] = (lane[3] ^ word) * HASH_MUL;
+    }
+
+    uint64_t hash = lane[0] ^ (lane[1] << 17 | lane[1] >> 47) ^
+                    (lane[2] << 31 | lane[2] >> 33) ^ (lane[3] << 47 | lane[3] >> 17) ^ len;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
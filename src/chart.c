@@ -0,0 +1,329 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Chart and sparkline widgets. Samples go into a fixed-size ring and are
+ * folded into the min/max of their column as they arrive; column c holds
+ * samples [c * per_column, (c + 1) * per_column), so the ring is only
+ * read again when the widget is resized. The columns themselves are a
+ * ring of `width` entries, the newest on the right.
+ *
+ * Cells hold one byte, so there are no Braille or block glyphs. A chart
+ * row is split into two halves drawn with '.' (lower), '\'' (upper) and
+ * ':' (both); a sparkline draws each column's peak with a glyph whose
+ * height follows the value.
+ */
+
+#define GT_CHART_MIN_SAMPLES 16
+
+static const char sparkline_ramp[] = "_.-'";
+
+struct gt_chart_column {
+    double min, max;
+};
+
+struct gt_chart {
+    double *samples;
+    size_t capacity;
+    uint64_t count;                 // samples pushed, absolute
+    struct gt_chart_column *columns;
+    int width, height;              // what columns and cells were built for
+    size_t per_column;
+    uint64_t kept_from;             // first column with samples left after a resize
+    double lo, hi;                  // value range drawn
+    bool fixed_range;
+    bool sparkline;
+    gt_cell_t *cells;
+    int damage_from;                // first column to draw again, -1 none
+};
+
+static struct gt_chart *chart_of(gt_widget_t *widget) {
+    if (!widget || widget->type != GT_WIDGET_CHART) return NULL;
+    return widget->ext.chart;
+}
+
+static uint64_t column_count(const struct gt_chart *chart) {
+    return chart->count == 0 ? 0 : (chart->count - 1) / chart->per_column + 1;
+}
+
+// Absolute number of the leftmost column on screen
+static uint64_t first_column(const struct gt_chart *chart) {
+    uint64_t columns = column_count(chart);
+    return columns > (uint64_t)chart->width ? columns - (uint64_t)chart->width : 0;
+}
+
+// Leftmost column that has something to draw. When a resize makes
+// columns narrower than the ring, the older ones have nothing left
+static uint64_t first_kept(const struct gt_chart *chart) {
+    uint64_t first = first_column(chart);
+    return first > chart->kept_from ? first : chart->kept_from;
+}
+
+static const struct gt_chart_column *column_at(const struct gt_chart *chart, uint64_t column) {
+    return &chart->columns[column % (uint64_t)chart->width];
+}
+
+// Fit the range to the columns on screen; false if it did not change
+static bool fit_range(struct gt_chart *chart) {
+    if (chart->fixed_range || chart->count == 0) return false;
+
+    uint64_t first = first_kept(chart), end = column_count(chart);
+    double lo = column_at(chart, first)->min, hi = column_at(chart, first)->max;
+    for (uint64_t c = first + 1; c < end; c++) {
+        const struct gt_chart_column *col = column_at(chart, c);
+        if (col->min < lo) lo = col->min;
+        if (col->max > hi) hi = col->max;
+    }
+    if (lo == chart->lo && hi == chart->hi) return false;
+    chart->lo = lo;
+    chart->hi = hi;
+    return true;
+}
+
+// Build the columns for the widget's size from the samples still in the ring
+static int chart_resize(struct gt_chart *chart, int width, int height) {
+    struct gt_chart_column *columns = gt_malloc((size_t)width * sizeof(struct gt_chart_column));
+    gt_cell_t *cells = gt_malloc((size_t)width * (size_t)height * sizeof(gt_cell_t));
+    if (!columns || !cells) {
+        free(columns);
+        free(cells);
+        return -1;
+    }
+    free(chart->columns);
+    free(chart->cells);
+    chart->columns = columns;
+    chart->cells = cells;
+    chart->width = width;
+    chart->height = height;
+    chart->per_column = chart->capacity / (size_t)width > 0 ? chart->capacity / (size_t)width : 1;
+
+    uint64_t oldest = chart->count > chart->capacity ? chart->count - chart->capacity : 0;
+    chart->kept_from = oldest / chart->per_column;
+    for (uint64_t c = first_kept(chart); c < column_count(chart); c++) {
+        struct gt_chart_column *col = &columns[c % (uint64_t)width];
+        uint64_t from = c * chart->per_column, to = from + chart->per_column;
+        if (from < oldest) from = oldest;
+        if (to > chart->count) to = chart->count;
+        col->min = col->max = chart->samples[from % chart->capacity];
+        for (uint64_t n = from + 1; n < to; n++) {
+            double value = chart->samples[n % chart->capacity];
+            if (value < col->min) col->min = value;
+            if (value > col->max) col->max = value;
+        }
+    }
+    fit_range(chart);
+    return 0;
+}
+
+static gt_widget_t *create_chart(gt_window_t *window, int x, int y, int width, int height, size_t capacity, bool sparkline) {
+    if (!window || width <= 0 || height <= 0) return NULL;
+    if (capacity < GT_CHART_MIN_SAMPLES) capacity = GT_CHART_MIN_SAMPLES;
+
+    gt_widget_t *widget = gt_malloc(sizeof(gt_widget_t));
+    struct gt_chart *chart = gt_malloc(sizeof(struct gt_chart));
+    double *samples = gt_malloc(capacity * sizeof(double));
+    if (!widget || !chart || !samples) {
+        free(widget);
+        free(chart);
+        free(samples);
+        return NULL;
+    }
+
+    memset(chart, 0, sizeof(*chart));
+    chart->samples = samples;
+    chart->capacity = capacity;
+    chart->sparkline = sparkline;
+    chart->damage_from = -1;
+    if (chart_resize(chart, width, height) != 0) {
+        free(widget);
+        free(chart);
+        free(samples);
+        return NULL;
+    }
+
+    widget->type = GT_WIDGET_CHART;
+    widget->x = x;
+    widget->y = y;
+    widget->width = width;
+    widget->height = height;
+    widget->text = NULL;
+    widget->style = gt_style_intern(GT_COLOR_GREEN, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    widget->visible = true;
+    widget->focused = false;
+    gt_invalidate_widget(widget);
+    widget->callback = NULL;
+    widget->user_data = NULL;
+    widget->ext.chart = chart;
+    widget->layout = NULL;
+    widget->next = window->widgets;
+    window->widgets = widget;
+
+    return widget;
+}
+
+gt_widget_t *gt_create_chart(gt_window_t *window, int x, int y, int width, int height, size_t capacity) {
+    return create_chart(window, x, y, width, height, capacity, false);
+}
+
+gt_widget_t *gt_create_sparkline(gt_window_t *window, int x, int y, int width, size_t capacity) {
+    return create_chart(window, x, y, width, 1, capacity, true);
+}
+
+void gt_chart_push(gt_widget_t *widget, double value) {
+    struct gt_chart *chart = chart_of(widget);
+    if (!chart || !isfinite(value)) return;
+
+    uint64_t n = chart->count++;
+    chart->samples[n % chart->capacity] = value;
+
+    uint64_t column = n / chart->per_column;
+    struct gt_chart_column *col = &chart->columns[column % (uint64_t)chart->width];
+    bool opened = n % chart->per_column == 0;
+    if (opened) {
+        col->min = col->max = value;
+    } else {
+        if (value < col->min) col->min = value;
+        if (value > col->max) col->max = value;
+    }
+
+    // Laid out at a new size since it was drawn, the render rebuilds it
+    if (chart->width != widget->width || chart->height != widget->height) {
+        gt_invalidate_widget(widget);
+        return;
+    }
+
+    // A new column past the right edge shifts every column left, and may
+    // drop the one that held the lowest or highest value
+    bool shifted = opened && column >= (uint64_t)chart->width;
+    bool outside = n == 0 || value < chart->lo || value > chart->hi;
+    if (!chart->fixed_range && (shifted || outside) && fit_range(chart)) {
+        gt_invalidate_widget(widget);
+        return;
+    }
+
+    int from = shifted ? 0 : (int)(column - first_column(chart));
+    if (chart->damage_from < 0 || from < chart->damage_from) chart->damage_from = from;
+    gt_request_frame();
+}
+
+// min >= max, or a bound that is not finite, draws the range of the
+// samples on screen
+void gt_chart_set_range(gt_widget_t *widget, double min, double max) {
+    struct gt_chart *chart = chart_of(widget);
+    if (!chart) return;
+
+    chart->fixed_range = min < max && isfinite(min) && isfinite(max);
+    if (chart->fixed_range) {
+        chart->lo = min;
+        chart->hi = max;
+    } else {
+        chart->lo = chart->hi = 0;
+        fit_range(chart);
+    }
+    gt_invalidate_widget(widget);
+}
+
+void gt_chart_clear(gt_widget_t *widget) {
+    struct gt_chart *chart = chart_of(widget);
+    if (!chart) return;
+
+    chart->count = 0;
+    chart->kept_from = 0;
+    if (!chart->fixed_range) chart->lo = chart->hi = 0;
+    gt_invalidate_widget(widget);
+}
+
+size_t gt_chart_sample_count(gt_widget_t *widget) {
+    struct gt_chart *chart = chart_of(widget);
+    if (!chart) return 0;
+    return chart->count < chart->capacity ? (size_t)chart->count : chart->capacity;
+}
+
+// Position of value in [0, steps - 1]
+static int scale(const struct gt_chart *chart, double value, int steps) {
+    if (chart->hi <= chart->lo) return steps / 2;
+    double pos = (value - chart->lo) / (chart->hi - chart->lo) * (double)(steps - 1) + 0.5;
+    if (!(pos >= 0)) return 0;      // also NaN
+    if (pos >= (double)steps) return steps - 1;
+    return (int)pos;
+}
+
+// Draw screen column x into the cell buffer
+static void draw_column(const gt_widget_t *widget, const struct gt_chart *chart, int x) {
+    const struct gt_style *style = gt_style_get(widget->style);
+    gt_cell_t blank = { ' ', style->fg, style->bg, style->attr };
+    for (int row = 0; row < chart->height; row++) chart->cells[(size_t)row * (size_t)chart->width + (size_t)x] = blank;
+
+    uint64_t column = first_column(chart) + (uint64_t)x;
+    if (column < first_kept(chart) || column >= column_count(chart)) return;
+    const struct gt_chart_column *col = column_at(chart, column);
+
+    if (chart->sparkline) {
+        int level = scale(chart, col->max, (int)sizeof(sparkline_ramp) - 1);
+        chart->cells[x].ch = sparkline_ramp[level];
+        return;
+    }
+
+    // Half rows counted from the bottom, two per row
+    int halves = chart->height * 2;
+    int low = scale(chart, col->min, halves), high = scale(chart, col->max, halves);
+    for (int half = low / 2 * 2; half <= high; half += 2) {
+        bool lower = half >= low;
+        bool upper = half + 1 >= low && half + 1 <= high;
+        int row = chart->height - 1 - half / 2;
+        chart->cells[(size_t)row * (size_t)chart->width + (size_t)x].ch = lower && upper ? ':' : upper ? '\'' : '.';
+    }
+}
+
+static void blit_columns(gt_window_t *window, gt_widget_t *widget, struct gt_chart *chart, int from) {
+    for (int x = from; x < chart->width; x++) draw_column(widget, chart, x);
+    gt_blit_cells(window, widget->x + from, widget->y, chart->width - from, chart->height,
+                  chart->cells + from, (size_t)chart->width);
+    chart->damage_from = -1;
+}
+
+void gt_chart_render(gt_window_t *window, gt_widget_t *widget) {
+    struct gt_chart *chart = chart_of(widget);
+    if (!chart) return;
+
+    // Laid out at a new size: fold the ring into columns for it
+    if ((chart->width != widget->width || chart->height != widget->height) &&
+        (widget->width <= 0 || widget->height <= 0 || chart_resize(chart, widget->width, widget->height) != 0)) return;
+    blit_columns(window, widget, chart, 0);
+}
+
+// Draw only the columns new samples changed or shifted
+void gt_chart_render_changed(gt_window_t *window, gt_widget_t *widget) {
+    struct gt_chart *chart = chart_of(widget);
+    if (!chart || chart->damage_from < 0 || !widget->visible) return;
+    blit_columns(window, widget, chart, chart->damage_from);
+}
+
+void gt_chart_destroy(gt_widget_t *widget) {
+    struct gt_chart *chart = chart_of(widget);
+    if (!chart) return;
+    free(chart->samples);
+    free(chart->columns);
+    free(chart->cells);
+    free(chart);
+    widget->ext.chart = NULL;
+}
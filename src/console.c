@@ -0,0 +1,317 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Console widget: a fixed-capacity byte ring plus a ring of line start
+ * offsets. All offsets are absolute (they only grow), so a position is
+ * mapped into the ring with "% cap" and eviction is just moving `tail`.
+ */
+
+#define GT_CONSOLE_MIN_BYTES 256
+#define GT_CONSOLE_MIN_LINES 8
+
+struct gt_console {
+    char *buf;
+    size_t cap;
+    uint64_t head, tail;        // absolute byte offsets, tail <= head
+    uint64_t *lines;            // ring of line start offsets
+    size_t line_cap;
+    uint64_t first_line;        // absolute number of the oldest line
+    uint64_t line_count;        // always >= 1 (the open last line)
+    uint64_t top_line;          // first visible line when not following
+    bool follow;
+    bool wrap;
+};
+
+static uint64_t console_line_start(const struct gt_console *con, uint64_t n) {
+    return con->lines[n % con->line_cap];
+}
+
+// End of line n, excluding its trailing '\n'
+static uint64_t console_line_end(const struct gt_console *con, uint64_t n) {
+    if (n + 1 < con->first_line + con->line_count) {
+        return console_line_start(con, n + 1) - 1;
+    }
+    return con->head;
+}
+
+static void console_drop_first_line(struct gt_console *con) {
+    con->first_line++;
+    con->line_count--;
+    if (con->tail < console_line_start(con, con->first_line)) {
+        con->tail = console_line_start(con, con->first_line);
+    }
+}
+
+// Forget lines whose bytes were overwritten by the ring
+static void console_trim(struct gt_console *con) {
+    while (con->line_count > 1 && console_line_start(con, con->first_line + 1) <= con->tail) {
+        console_drop_first_line(con);
+    }
+    if (console_line_start(con, con->first_line) < con->tail) {
+        con->lines[con->first_line % con->line_cap] = con->tail;
+    }
+}
+
+static void console_write(struct gt_console *con, const char *data, size_t len) {
+    // Only the last `cap` bytes can survive, skip the rest
+    if (len > con->cap) {
+        con->head += len - con->cap;
+        data += len - con->cap;
+        len = con->cap;
+    }
+
+    size_t pos = con->head % con->cap;
+    size_t first = con->cap - pos < len ? con->cap - pos : len;
+    memcpy(con->buf + pos, data, first);
+    memcpy(con->buf, data + first, len - first);
+    con->head += len;
+
+    if (con->head - con->tail > con->cap) {
+        con->tail = con->head - con->cap;
+    }
+}
+
+static void console_push_line(struct gt_console *con) {
+    if (con->line_count == con->line_cap) {
+        console_drop_first_line(con);
+    }
+    con->lines[(con->first_line + con->line_count) % con->line_cap] = con->head;
+    con->line_count++;
+}
+
+static struct gt_console *console_of(gt_widget_t *widget) {
+    if (!widget || widget->type != GT_WIDGET_CONSOLE) return NULL;
+    return widget->ext.console;
+}
+
+gt_widget_t *gt_create_console(gt_window_t *window, int x, int y, int width, int height, size_t max_bytes) {
+    if (!window || width <= 0 || height <= 0) return NULL;
+
+    if (max_bytes < GT_CONSOLE_MIN_BYTES) max_bytes = GT_CONSOLE_MIN_BYTES;
+
+    // One fifth of the budget goes to the line index, the rest to text
+    size_t line_cap = max_bytes / 5 / sizeof(uint64_t);
+    if (line_cap < GT_CONSOLE_MIN_LINES) line_cap = GT_CONSOLE_MIN_LINES;
+    size_t cap = max_bytes - line_cap * sizeof(uint64_t);
+
+    gt_widget_t *widget = gt_malloc(sizeof(gt_widget_t));
+    struct gt_console *con = gt_malloc(sizeof(struct gt_console));
+    char *buf = gt_malloc(cap);
+    uint64_t *lines = gt_malloc(line_cap * sizeof(uint64_t));
+    if (!widget || !con || !buf || !lines) {
+        free(widget);
+        free(con);
+        free(buf);
+        free(lines);
+        return NULL;
+    }
+
+    con->buf = buf;
+    con->cap = cap;
+    con->head = con->tail = 0;
+    con->lines = lines;
+    con->line_cap = line_cap;
+    con->lines[0] = 0;
+    con->first_line = 0;
+    con->line_count = 1;
+    con->top_line = 0;
+    con->follow = true;
+    con->wrap = false;
+
+    widget->type = GT_WIDGET_CONSOLE;
+    widget->x = x;
+    widget->y = y;
+    widget->width = width;
+    widget->height = height;
+    widget->text = NULL;
+    widget->style = gt_style_intern(GT_COLOR_WHITE, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    widget->visible = true;
+    widget->focused = false;
+    gt_invalidate_widget(widget);
+    widget->callback = NULL;
+    widget->user_data = NULL;
+    widget->ext.console = con;
+    widget->layout = NULL;
+    widget->next = window->widgets;
+    window->widgets = widget;
+
+    return widget;
+}
+
+void gt_console_append(gt_widget_t *widget, const char *text, size_t len) {
+    struct gt_console *con = console_of(widget);
+    if (!con || !text) return;
+
+    while (len > 0) {
+        const char *nl = memchr(text, '\n', len);
+        size_t seg = nl ? (size_t)(nl - text) + 1 : len;
+
+        console_write(con, text, seg);
+        if (nl) console_push_line(con);
+        console_trim(con);
+
+        text += seg;
+        len -= seg;
+    }
+
+    // A scrolled-back view only changes if its lines were evicted
+    if (con->follow || con->top_line < con->first_line) gt_invalidate_widget(widget);
+}
+
+void gt_console_append_line(gt_widget_t *widget, const char *line) {
+    if (!line) return;
+    gt_console_append(widget, line, strlen(line));
+    gt_console_append(widget, "\n", 1);
+}
+
+void gt_console_clear(gt_widget_t *widget) {
+    struct gt_console *con = console_of(widget);
+    if (!con) return;
+
+    con->tail = con->head;
+    con->first_line += con->line_count - 1;
+    con->line_count = 1;
+    con->lines[con->first_line % con->line_cap] = con->head;
+    con->top_line = con->first_line;
+    gt_invalidate_widget(widget);
+}
+
+void gt_console_set_wrap(gt_widget_t *widget, bool wrap) {
+    struct gt_console *con = console_of(widget);
+    if (!con) return;
+    con->wrap = wrap;
+    gt_invalidate_widget(widget);
+}
+
+void gt_console_set_follow(gt_widget_t *widget, bool follow) {
+    struct gt_console *con = console_of(widget);
+    if (!con) return;
+    con->follow = follow;
+    gt_invalidate_widget(widget);
+}
+
+void gt_console_scroll(gt_widget_t *widget, int lines) {
+    struct gt_console *con = console_of(widget);
+    if (!con) return;
+
+    uint64_t last = con->first_line + con->line_count - 1;
+    uint64_t bottom_top = last + 1 >= con->first_line + (uint64_t)widget->height ?
+                          last + 1 - (uint64_t)widget->height : con->first_line;
+    uint64_t top = con->follow ? bottom_top : con->top_line;
+    if (top < con->first_line) top = con->first_line;
+
+    if (lines < 0) {
+        uint64_t up = (uint64_t)(-(int64_t)lines);
+        top = top - con->first_line > up ? top - up : con->first_line;
+    } else {
+        top += (uint64_t)lines;
+    }
+
+    // Scrolling back to the bottom resumes following the tail
+    if (top >= bottom_top) {
+        con->follow = true;
+    } else {
+        con->follow = false;
+        con->top_line = top;
+    }
+    gt_invalidate_widget(widget);
+}
+
+size_t gt_console_line_count(gt_widget_t *widget) {
+    struct gt_console *con = console_of(widget);
+    return con ? (size_t)con->line_count : 0;
+}
+
+static int console_line_rows(const struct gt_console *con, uint64_t n, int width) {
+    if (!con->wrap) return 1;
+    uint64_t len = console_line_end(con, n) - console_line_start(con, n);
+    return len == 0 ? 1 : (int)((len + (uint64_t)width - 1) / (uint64_t)width);
+}
+
+static void console_draw_row(gt_window_t *window, gt_widget_t *widget, int row,
+                             uint64_t from, uint64_t to) {
+    const struct gt_console *con = widget->ext.console;
+    const struct gt_style *style = gt_style_get(widget->style);
+
+    for (int x = 0; x < widget->width; x++) {
+        char ch = ' ';
+        if (from + (uint64_t)x < to) {
+            ch = con->buf[(from + (uint64_t)x) % con->cap];
+            if ((unsigned char)ch < 32 || ch == 127) ch = ' ';
+        }
+        gt_draw_char(window, widget->x + x, widget->y + row, ch,
+                     style->fg, style->bg, style->attr);
+    }
+}
+
+// Wrapping is only computed for the lines that end up on screen
+void gt_console_render(gt_window_t *window, gt_widget_t *widget) {
+    struct gt_console *con = console_of(widget);
+    if (!con) return;
+
+    int width = widget->width;
+    int height = widget->height;
+    uint64_t last = con->first_line + con->line_count - 1;
+    uint64_t line;
+    int skip = 0;
+
+    if (con->follow) {
+        // Walk back from the tail until the viewport is full
+        int rows = 0;
+        line = last;
+        for (;;) {
+            rows += console_line_rows(con, line, width);
+            if (rows >= height || line == con->first_line) break;
+            line--;
+        }
+        if (rows > height) skip = rows - height;
+    } else {
+        line = con->top_line < con->first_line ? con->first_line : con->top_line;
+        if (line > last) line = last;
+    }
+
+    int row = 0;
+    for (; line <= last && row < height; line++) {
+        uint64_t start = console_line_start(con, line);
+        uint64_t end = console_line_end(con, line);
+        int rows = console_line_rows(con, line, width);
+
+        for (int r = skip; r < rows && row < height; r++, row++) {
+            uint64_t from = start + (uint64_t)r * (uint64_t)width;
+            console_draw_row(window, widget, row, from, end);
+        }
+        skip = 0;
+    }
+
+    for (; row < height; row++) {
+        console_draw_row(window, widget, row, 0, 0);
+    }
+}
+
+void gt_console_destroy(gt_widget_t *widget) {
+    struct gt_console *con = console_of(widget);
+    if (!con) return;
+    free(con->buf);
+    free(con->lines);
+    free(con);
+    widget->ext.console = NULL;
+}
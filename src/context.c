@@ -0,0 +1,86 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * Terminal contexts. Each thread works on the context it bound with
+ * gt_bind_context(); threads that never bind one share the default
+ * context on stdin/stdout, so single-terminal programs need no changes.
+ * A context must only be used by one thread at a time.
+ *
+ * A headless context has no terminal behind it: the size is fixed, no
+ * input ever arrives and the frames are written to any fd, which is
+ * what replaying recordings and measuring offline need.
+ */
+
+#define GT_CONTEXT_INITIALIZER(in, out) {                       \
+    .in_fd = (in),                                              \
+    .out_fd = (out),                                            \
+    .term_width = 80,                                           \
+    .term_height = 24,                                          \
+    .screen = { .cursor_x = -1, .cursor_y = -1 },               \
+    .output = { .fd = -1, .saved_flags = -1 },                  \
+    .frame = { .interval_ns = 1000000000ull / GT_DEFAULT_FPS,   \
+               .wake_fds = { -1, -1 } },                        \
+}
+
+gt_context_t gt_default_context = GT_CONTEXT_INITIALIZER(STDIN_FILENO, STDOUT_FILENO);
+__thread gt_context_t *gt_bound_context = NULL;
+
+gt_context_t *gt_create_context(int in_fd, int out_fd) {
+    if (in_fd < 0 || out_fd < 0) return NULL;
+
+    gt_context_t *context = gt_malloc(sizeof(gt_context_t));
+    if (!context) return NULL;
+
+    gt_context_t initial = GT_CONTEXT_INITIALIZER(in_fd, out_fd);
+    *context = initial;
+    return context;
+}
+
+gt_context_t *gt_create_headless_context(int out_fd, int width, int height) {
+    if (width <= 0 || height <= 0) return NULL;
+
+    gt_context_t *context = gt_create_context(out_fd, out_fd);
+    if (!context) return NULL;
+
+    context->in_fd = -1;
+    context->headless = true;
+    context->term_width = width;
+    context->term_height = height;
+    return context;
+}
+
+// Call gt_cleanup() and destroy the windows with the context bound first
+void gt_destroy_context(gt_context_t *context) {
+    if (!context || context == &gt_default_context) return;
+    if (gt_bound_context == context) gt_bound_context = NULL;
+    gt_frame_close_wakeup(context);
+    free(context);
+}
+
+// NULL goes back to the default context
+void gt_bind_context(gt_context_t *context) {
+    gt_bound_context = context == &gt_default_context ? NULL : context;
+}
+
+gt_context_t *gt_get_context(void) {
+    return gt_ctx();
+}
@@ -16,48 +16,145 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
 #include "gtlib.h"
+#include <errno.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/select.h>
 #include <termios.h>
 
-int gt_wait_event(gt_event_t *event, int timeout) {
-    if (!event) return -1;
-    
-    fd_set readfds;
-    struct timeval tv;
-    
-    FD_ZERO(&readfds);
-    FD_SET(STDIN_FILENO, &readfds);
+// Queue bytes read elsewhere (e.g. during terminal queries) as input
+void gt_input_push(const void *data, size_t len) {
+    gt_context_t *ctx = gt_ctx();
+    if (len > sizeof(ctx->input_buf) - ctx->input_len) len = sizeof(ctx->input_buf) - ctx->input_len;
+    memcpy(ctx->input_buf + ctx->input_len, data, len);
+    ctx->input_len += len;
+}
+
+// Decode one key from input_buf, returns the number of bytes used
+static size_t decode_key(gt_key_t *key) {
+    gt_context_t *ctx = gt_ctx();
+    const unsigned char *buf = ctx->input_buf;
     
-    if (timeout >= 0) {
-        tv.tv_sec = timeout / 1000;
-        tv.tv_usec = (timeout % 1000) * 1000;
+    if (buf[0] != 27 || ctx->input_len == 1 || (buf[1] != '[' && buf[1] != 'O')) {
+        *key = buf[0];
+        return 1;
+    }
+    if (ctx->input_len == 2) {
+        *key = GT_KEY_UNKNOWN;
+        return 2;
     }
     
-    int ret = select(STDIN_FILENO + 1, &readfds, NULL, NULL, timeout >= 0 ? &tv : NULL);
+    switch (buf[2]) {
+        case 'A': *key = GT_KEY_UP; return 3;
+        case 'B': *key = GT_KEY_DOWN; return 3;
+        case 'C': *key = GT_KEY_RIGHT; return 3;
+        case 'D': *key = GT_KEY_LEFT; return 3;
+        case 'H': *key = GT_KEY_HOME; return 3;
+        case 'F': *key = GT_KEY_END; return 3;
+    }
     
-    if (ret <= 0) return ret;
+    if (ctx->input_len >= 4 && buf[3] == '~') {
+        switch (buf[2]) {
+            case '1': case '7': *key = GT_KEY_HOME; break;
+            case '4': case '8': *key = GT_KEY_END; break;
+            case '3': *key = GT_KEY_FORWARD_DELETE; break;
+            default: *key = GT_KEY_UNKNOWN;
+        }
+        return 4;
+    }
     
-    char buf[3];
-    int n = read(STDIN_FILENO, buf, sizeof(buf));
+    // Skip any other sequence up to its final byte
+    size_t i = 2;
+    while (i < ctx->input_len && (buf[i] < 0x40 || buf[i] > 0x7e)) i++;
+    *key = GT_KEY_UNKNOWN;
+    return i < ctx->input_len ? i + 1 : ctx->input_len;
+}
+
+// Returns 0 with an event, 1 if none came before the timeout, -1 on error
+int gt_wait_event(gt_event_t *event, int timeout) {
+    gt_context_t *ctx = gt_ctx();
+    if (!event) return -1;
     
-    if (n <= 0) return -1;
+    if (ctx->input_len == 0) {
+        fd_set readfds, writefds;
+        struct timeval tv;
+        uint64_t deadline = timeout >= 0 ? gt_now_ns() + (uint64_t)timeout * 1000000ull : 0;
+        int out_fd = gt_output_fd();
+        
+        // Render pending frames and drain queued output while waiting
+        for (;;) {
+            gt_run_frame();
+            
+            int wait = timeout;
+            if (timeout >= 0) {
+                uint64_t now = gt_now_ns();
+                wait = now >= deadline ? 0 : (int)((deadline - now) / 1000000);
+            }
+            int frame_wait = gt_frame_wait_ms();
+            if (frame_wait >= 0 && (wait < 0 || frame_wait < wait)) wait = frame_wait;
+            
+            FD_ZERO(&readfds);
+            FD_ZERO(&writefds);
+            if (ctx->in_fd >= 0) FD_SET(ctx->in_fd, &readfds);
+            int max_fd = ctx->in_fd;
+            bool writing = out_fd >= 0 && gt_output_pending() > 0;
+            if (writing) {
+                FD_SET(out_fd, &writefds);
+                if (out_fd > max_fd) max_fd = out_fd;
+            }
+            int wake_fd = gt_frame_wakeup_fd();
+            if (wake_fd >= 0) {
+                FD_SET(wake_fd, &readfds);
+                if (wake_fd > max_fd) max_fd = wake_fd;
+            }
+            max_fd = gt_share_fds(&readfds, &writefds, max_fd);
+            
+            if (wait >= 0) {
+                tv.tv_sec = wait / 1000;
+                tv.tv_usec = (wait % 1000) * 1000;
+            }
+            
+            int ret = select(max_fd + 1, &readfds, &writefds, NULL, wait >= 0 ? &tv : NULL);
+            if (ret < 0) {
+                if (errno == EINTR) continue;
+                return -1;
+            }
+            
+            // Once the terminal caught up, send the latest frame
+            if (writing && FD_ISSET(out_fd, &writefds)) {
+                gt_output_drain();
+                if (gt_output_pending() == 0 && gt_screen_flush_pending()) gt_screen_flush();
+            }
+            
+            // Another thread wants a frame; the next gt_run_frame() picks it up
+            if (wake_fd >= 0 && FD_ISSET(wake_fd, &readfds)) gt_frame_drain_wakeup();
+            
+            // Viewers are served after the terminal, and may type too
+            gt_share_handle(&readfds, &writefds);
+            if (ctx->input_len > 0 || (ctx->in_fd >= 0 && FD_ISSET(ctx->in_fd, &readfds))) break;
+            
+            // 1 means the timeout expired without an event
+            if (timeout >= 0 && gt_now_ns() >= deadline) return 1;
+        }
+        
+        if (ctx->input_len == 0) {
+            ssize_t n = read(ctx->in_fd, ctx->input_buf, sizeof(ctx->input_buf));
+            if (n < 0 && (errno == EAGAIN || errno == EINTR)) return 1;
+            if (n <= 0) return -1;
+            ctx->input_len = (size_t)n;
+        }
+    }
     
+    GT_TRACE_BEGIN(start);
     event->type = GT_EVENT_KEY_PRESS;
     
-    if (n == 1) {
-        event->data.key = buf[0];
-    } else if (n == 3 && buf[0] == 27 && buf[1] == '[') {
-        switch (buf[2]) {
-            case 'A': event->data.key = GT_KEY_UP; break;
-            case 'B': event->data.key = GT_KEY_DOWN; break;
-            case 'C': event->data.key = GT_KEY_RIGHT; break;
-            case 'D': event->data.key = GT_KEY_LEFT; break;
-            default: event->data.key = GT_KEY_UNKNOWN;
-        }
-    } else {
-        event->data.key = GT_KEY_UNKNOWN;
-    }
+    size_t used = decode_key(&event->data.key);
+    ctx->input_len -= used;
+    memmove(ctx->input_buf, ctx->input_buf + used, ctx->input_len);
+    ctx->counters.events_received++;
+    gt_stats_input_event(gt_now_ns());
+    gt_record_event(event);
+    GT_TRACE_END(start, "input_decode");
     
     return 0;
 }
@@ -0,0 +1,139 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/select.h>
+
+/*
+ * Frame scheduler. Changes only request a frame; the frame itself is
+ * rendered by gt_run_frame() at most once per frame interval, so a burst
+ * of updates between two frames costs a single repaint.
+ *
+ * Other threads request a frame with gt_frame_wake(): it sets the
+ * context's `wanted` flag, which the next gt_run_frame() turns into a
+ * pending frame, and writes a byte to the context's pipe when the flag
+ * was clear, so a gt_wait_event() sleeping in select() wakes up. The
+ * pipe lives as long as the context, so a late wake never writes to a
+ * closed fd.
+ */
+
+void gt_set_frame_rate(int fps) {
+    struct gt_frame *frame = &gt_ctx()->frame;
+    frame->interval_ns = fps > 0 ? 1000000000ull / (uint64_t)fps : 0;
+}
+
+void gt_request_frame(void) {
+    struct gt_frame *frame = &gt_ctx()->frame;
+    if (frame->pending) gt_ctx()->counters.events_coalesced++;
+    frame->pending = true;
+}
+
+void gt_invalidate_widget(gt_widget_t *widget) {
+    widget->dirty = true;
+    gt_request_frame();
+}
+
+// Milliseconds until the pending frame is due, -1 if none is pending
+int gt_frame_wait_ms(void) {
+    struct gt_frame *frame = &gt_ctx()->frame;
+    if (!frame->pending) return -1;
+
+    uint64_t now = gt_now_ns();
+    uint64_t due = frame->last_ns + frame->interval_ns;
+    if (now >= due) return 0;
+
+    return (int)((due - now + 999999) / 1000000);
+}
+
+// Create the context's wakeup pipe, once
+int gt_frame_open_wakeup(void) {
+    struct gt_frame *frame = &gt_ctx()->frame;
+    if (frame->wake_fds[0] >= 0) return 0;
+
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    if (fds[0] >= FD_SETSIZE || fds[1] >= FD_SETSIZE) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL, 0) | O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    frame->wake_fds[0] = fds[0];
+    __atomic_store_n(&frame->wake_fds[1], fds[1], __ATOMIC_RELEASE);
+    return 0;
+}
+
+void gt_frame_close_wakeup(gt_context_t *context) {
+    struct gt_frame *frame = &context->frame;
+    if (frame->wake_fds[0] < 0) return;
+    close(frame->wake_fds[0]);
+    close(frame->wake_fds[1]);
+    frame->wake_fds[0] = frame->wake_fds[1] = -1;
+}
+
+// Request a frame on a context another thread renders. Safe from any thread
+void gt_frame_wake(gt_context_t *context) {
+    struct gt_frame *frame = &context->frame;
+    if (__atomic_exchange_n(&frame->wanted, true, __ATOMIC_ACQ_REL)) return;
+
+    // A full pipe already holds a wakeup
+    int fd = __atomic_load_n(&frame->wake_fds[1], __ATOMIC_ACQUIRE);
+    if (fd >= 0) {
+        char byte = 0;
+        ssize_t ret = write(fd, &byte, 1);
+        (void)ret;
+    }
+}
+
+// Read end of the wakeup pipe for select(), -1 if there is none
+int gt_frame_wakeup_fd(void) {
+    return gt_ctx()->frame.wake_fds[0];
+}
+
+void gt_frame_drain_wakeup(void) {
+    int fd = gt_ctx()->frame.wake_fds[0];
+    char buf[64];
+    while (fd >= 0 && read(fd, buf, sizeof(buf)) > 0) {}
+}
+
+int gt_run_frame(void) {
+    struct gt_frame *frame = &gt_ctx()->frame;
+    if (__atomic_exchange_n(&frame->wanted, false, __ATOMIC_ACQ_REL)) frame->pending = true;
+    if (!frame->pending) return 0;
+
+    // After an idle period the frame is due at once
+    uint64_t now = gt_now_ns();
+    if (now - frame->last_ns < frame->interval_ns) return 0;
+
+    GT_TRACE_BEGIN(start);
+    frame->pending = false;
+    frame->last_ns = now;
+
+    for (gt_window_t *window = gt_window_list(); window; window = window->next) {
+        if (window->visible) gt_render_dirty_widgets(window);
+    }
+    gt_screen_flush();
+    gt_stats_frame_time(gt_now_ns() - now);
+    GT_TRACE_END(start, "frame");
+
+    return 1;
+}
@@ -0,0 +1,180 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Gauge widget: a bar showing a fraction, optionally with its percentage.
+ * The fraction is stored as 24-bit fixed point and may be set from any
+ * thread. What matters for drawing is the pattern it produces: the filled
+ * sub-cell steps and the percentage shown. A value that leaves the
+ * pattern as it was costs one atomic exchange and requests no frame;
+ * a frame redraws the gauge only if its pattern changed since the last.
+ * Other threads than the one that created the gauge request the frame
+ * through gt_frame_wake(), which wakes the context's gt_wait_event().
+ *
+ * Cells hold one byte, so there are no eighth-block glyphs; the cell at
+ * the end of the bar has three steps drawn from a density ramp.
+ */
+
+#define GT_GAUGE_ONE (1u << 24)
+#define GT_GAUGE_STEPS 3            // per cell
+#define GT_GAUGE_PERCENT_WIDTH 5    // " 100%"
+
+static const char gauge_ramp[GT_GAUGE_STEPS + 1] = " .:#";
+
+struct gt_gauge {
+    uint32_t value;                 // fraction * GT_GAUGE_ONE, atomic
+    bool percent;
+    uint64_t drawn;                 // pattern on screen, UINT64_MAX none
+    pthread_t owner;                // thread that may request frames directly
+    gt_context_t *context;          // the gauge is drawn on
+};
+
+static struct gt_gauge *gauge_of(gt_widget_t *widget) {
+    if (!widget || widget->type != GT_WIDGET_GAUGE) return NULL;
+    return widget->ext.gauge;
+}
+
+static int bar_width(const gt_widget_t *widget, const struct gt_gauge *gauge) {
+    if (gauge->percent && widget->width > GT_GAUGE_PERCENT_WIDTH) return widget->width - GT_GAUGE_PERCENT_WIDTH;
+    return widget->width;
+}
+
+static uint64_t steps_of(uint32_t value, int width) {
+    return (uint64_t)value * (uint64_t)width * GT_GAUGE_STEPS >> 24;
+}
+
+static uint32_t percent_of(uint32_t value) {
+    uint32_t percent = (uint32_t)((uint64_t)value * 100 >> 24);
+    return percent < 100 ? percent : 100;
+}
+
+// Everything the drawing depends on, in one number
+static uint64_t pattern(const gt_widget_t *widget, const struct gt_gauge *gauge, uint32_t value) {
+    uint64_t key = steps_of(value, bar_width(widget, gauge)) << 7;
+    if (gauge->percent && widget->width > GT_GAUGE_PERCENT_WIDTH) key |= percent_of(value);
+    return key;
+}
+
+gt_widget_t *gt_create_gauge(gt_window_t *window, int x, int y, int width) {
+    if (!window || width <= 0) return NULL;
+
+    gt_widget_t *widget = gt_malloc(sizeof(gt_widget_t));
+    struct gt_gauge *gauge = gt_malloc(sizeof(struct gt_gauge));
+    if (!widget || !gauge) {
+        free(widget);
+        free(gauge);
+        return NULL;
+    }
+    gauge->value = 0;
+    gauge->percent = false;
+    gauge->drawn = UINT64_MAX;
+    gauge->owner = pthread_self();
+    gauge->context = gt_ctx();
+
+    widget->type = GT_WIDGET_GAUGE;
+    widget->x = x;
+    widget->y = y;
+    widget->width = width;
+    widget->height = 1;
+    widget->text = NULL;
+    widget->style = gt_style_intern(GT_COLOR_GREEN, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    widget->visible = true;
+    widget->focused = false;
+    gt_invalidate_widget(widget);
+    widget->callback = NULL;
+    widget->user_data = NULL;
+    widget->ext.gauge = gauge;
+    widget->layout = NULL;
+    widget->next = window->widgets;
+    window->widgets = widget;
+
+    return widget;
+}
+
+// Safe from any thread
+void gt_gauge_set_value(gt_widget_t *widget, double fraction) {
+    struct gt_gauge *gauge = gauge_of(widget);
+    if (!gauge) return;
+
+    if (!(fraction > 0)) fraction = 0;
+    if (fraction > 1) fraction = 1;
+    uint32_t value = (uint32_t)(fraction * GT_GAUGE_ONE + 0.5);
+    uint32_t old = __atomic_exchange_n(&gauge->value, value, __ATOMIC_RELAXED);
+
+    if (pattern(widget, gauge, old) == pattern(widget, gauge, value)) return;
+    if (pthread_equal(pthread_self(), gauge->owner)) gt_request_frame();
+    else gt_frame_wake(gauge->context);
+}
+
+double gt_gauge_get_value(gt_widget_t *widget) {
+    struct gt_gauge *gauge = gauge_of(widget);
+    if (!gauge) return 0;
+    return (double)__atomic_load_n(&gauge->value, __ATOMIC_RELAXED) / GT_GAUGE_ONE;
+}
+
+void gt_gauge_set_percent(gt_widget_t *widget, bool show) {
+    struct gt_gauge *gauge = gauge_of(widget);
+    if (!gauge) return;
+    gauge->percent = show;
+    gt_invalidate_widget(widget);
+}
+
+void gt_gauge_render(gt_window_t *window, gt_widget_t *widget) {
+    struct gt_gauge *gauge = gauge_of(widget);
+    if (!gauge) return;
+
+    const struct gt_style *style = gt_style_get(widget->style);
+    uint32_t value = __atomic_load_n(&gauge->value, __ATOMIC_RELAXED);
+    int width = bar_width(widget, gauge);
+    uint64_t steps = steps_of(value, width);
+    int full = (int)(steps / GT_GAUGE_STEPS);
+    int part = (int)(steps % GT_GAUGE_STEPS);
+
+    gt_fill_rect(window, widget->x, widget->y, full, 1, gauge_ramp[GT_GAUGE_STEPS], style->fg, style->bg, style->attr);
+    if (full < width) {
+        gt_draw_char(window, widget->x + full, widget->y, gauge_ramp[part], style->fg, style->bg, style->attr);
+        gt_fill_rect(window, widget->x + full + 1, widget->y, width - full - 1, 1, ' ', style->fg, style->bg, style->attr);
+    }
+
+    if (width < widget->width) {
+        char text[GT_GAUGE_PERCENT_WIDTH + 1];
+        snprintf(text, sizeof(text), " %3u%%", (unsigned)percent_of(value));
+        gt_draw_string(window, widget->x + width, widget->y, text, style->fg, style->bg, style->attr);
+    }
+    gauge->drawn = pattern(widget, gauge, value);
+}
+
+// Redraw only if the value moved the bar or the percentage
+void gt_gauge_render_changed(gt_window_t *window, gt_widget_t *widget) {
+    struct gt_gauge *gauge = gauge_of(widget);
+    if (!gauge || !widget->visible) return;
+
+    uint32_t value = __atomic_load_n(&gauge->value, __ATOMIC_RELAXED);
+    if (pattern(widget, gauge, value) != gauge->drawn) gt_gauge_render(window, widget);
+}
+
+void gt_gauge_destroy(gt_widget_t *widget) {
+    struct gt_gauge *gauge = gauge_of(widget);
+    if (!gauge) return;
+    free(gauge);
+    widget->ext.gauge = NULL;
+}
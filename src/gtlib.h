@@ -19,6 +19,8 @@
 #define GTLIB_H
 
 #include "../include/ecomos-gtlib.h"
+#include <termios.h>
+#include <sys/select.h>
 
 /* Internal implementation */
 
@@ -29,22 +31,274 @@ struct gt_window {
     bool visible;
     struct gt_widget *widgets;
     struct gt_widget *focused_widget;
+    struct gt_layout *layout;   // Root of the window's layout tree, if any
+    struct gt_window *next;     // All windows, for the frame scheduler
+    gt_context_t *context;      // Context whose window list holds it
 };
 
+// Interned (fg, bg, attr) combination, see style.c
+typedef uint16_t gt_style_t;
+
+struct gt_style {
+    uint8_t fg, bg, attr;
+    uint8_t sgr_len;
+    char sgr[24];               // Selects the style from a reset pen
+};
+
+gt_style_t gt_style_intern(gt_color_t fg, gt_color_t bg, gt_attr_t attr);
+const struct gt_style *gt_style_get(gt_style_t id);
+
 // Widget structure definition
 struct gt_widget {
     gt_widget_type_t type;
     int x, y, width, height;
     char *text;
-    gt_color_t fg, bg;
-    gt_attr_t attr;
+    gt_style_t style;
     bool visible;
     bool focused;
+    bool dirty;                 // Needs a full repaint
     gt_button_callback_t callback;
     void *user_data;
+    union {
+        struct gt_console *console;
+        struct gt_textbox *textbox;
+        struct gt_viewport *viewport;
+        struct gt_chart *chart;
+        struct gt_gauge *gauge;
+    } ext;                      // Type specific state
+    struct gt_layout *layout;   // Layout leaf placing this widget, if any
     struct gt_widget *next;
 };
 
+/* Statistics and allocation */
+
+#define GT_HIST_SUB_BUCKETS 8
+#define GT_HIST_BUCKETS (62 * GT_HIST_SUB_BUCKETS)
+
+struct gt_histogram {
+    uint32_t counts[GT_HIST_BUCKETS];
+    uint64_t total;
+    uint64_t max;
+};
+
+void gt_hist_record(struct gt_histogram *hist, uint64_t value);
+uint64_t gt_hist_percentile(const struct gt_histogram *hist, double percentile);
+void gt_stats_frame_time(uint64_t ns);
+void gt_stats_input_event(uint64_t ns);
+uint64_t gt_stats_take_input(void);
+void gt_stats_input_latency(uint64_t ns);
+size_t gt_stats_overlay_text(char *buf, size_t size);
+void *gt_malloc(size_t size);
+void *gt_realloc(void *ptr, size_t size);
+char *gt_strdup(const char *str);
+
+/* Tracing, compiled in with -DGT_TRACE (make TRACE=1) */
+
+#ifdef GT_TRACE
+void gt_trace_record(const char *name, uint64_t start, uint64_t end);
+
+// Raw ticks, converted to nanoseconds when the trace is dumped
+static inline uint64_t gt_trace_clock(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return gt_now_ns();
+#endif
+}
+
+#define GT_TRACE_BEGIN(var) uint64_t var = gt_trace_clock()
+#define GT_TRACE_END(var, name) gt_trace_record(name, var, gt_trace_clock())
+#else
+#define GT_TRACE_BEGIN(var) ((void)0)
+#define GT_TRACE_END(var, name) ((void)0)
+#endif
+
+/* Per-terminal context. Everything that belongs to one terminal lives
+ * here; the APIs work on the context bound to the calling thread, or on
+ * the default stdin/stdout context when none is bound. */
+
+#define GT_DEFAULT_FPS 60
+#define GT_INPUT_BUFFER_SIZE 256
+
+struct gt_screen {
+    gt_cell_t *back;            // what was drawn
+    gt_cell_t *front;           // what the terminal shows
+    uint64_t *front_hash;       // row hashes of front
+    uint64_t *back_hash;        // row hashes of back, from the current flush
+    uint64_t blank_hash;        // hash of a blank row
+    uint8_t *row_dirty;         // rows drawn into since they were encoded
+    int width, height;
+    bool flush_pending;
+    int cursor_x, cursor_y;
+    bool cursor_visible;
+    bool sync_update;
+    bool repeat;
+    int render_threads;
+    struct gt_workers *workers;
+    struct gt_encoder *encoders; // blank rows, then one per band
+    int encoder_count;
+};
+
+struct gt_output {
+    int fd;
+    int saved_flags;
+    char *buf;
+    size_t cap;
+    size_t len;                 // bytes queued
+    size_t off;                 // bytes of the queue already written
+    size_t mark_left;           // bytes until the marked frame is written
+    uint64_t mark_input_ns;     // key the marked frame answers, 0 none
+};
+
+struct gt_frame {
+    bool pending;
+    uint64_t interval_ns;
+    uint64_t last_ns;
+    bool wanted;                // requested from another thread, atomic
+    int wake_fds[2];            // pipe that wakes gt_wait_event(), -1 without
+};
+
+struct gt_stats_state {
+    struct gt_histogram frame_times;
+    struct gt_histogram input_latency;
+    uint64_t input_pending_ns;  // oldest key not yet on screen, 0 none
+    bool latency_overlay;
+};
+
+struct gt_context {
+    int in_fd, out_fd;          // in_fd is -1 for headless contexts
+    bool headless;              // no terminal: fixed size, no input
+    bool initialized;
+    struct termios orig_termios;
+    int term_width, term_height;
+    unsigned char input_buf[GT_INPUT_BUFFER_SIZE];
+    size_t input_len;
+    gt_window_t *windows;
+    struct gt_screen screen;
+    struct gt_output output;
+    struct gt_frame frame;
+    struct gt_stats_state stats;
+    gt_stats_t counters;
+    struct gt_recorder *recorder;
+    struct gt_share *share;
+};
+
+extern gt_context_t gt_default_context;
+extern __thread gt_context_t *gt_bound_context;
+
+static inline gt_context_t *gt_ctx(void) {
+    return gt_bound_context ? gt_bound_context : &gt_default_context;
+}
+
+/* Window and frame internals */
+
+void gt_layout_update(gt_window_t *window);
+void gt_layout_widget_changed(gt_widget_t *widget);
+void gt_layout_widget_destroyed(gt_widget_t *widget);
+
+gt_window_t *gt_window_list(void);
+void gt_invalidate_widget(gt_widget_t *widget);
+int gt_frame_wait_ms(void);
+int gt_frame_open_wakeup(void);
+void gt_frame_close_wakeup(gt_context_t *context);
+void gt_frame_wake(gt_context_t *context);
+int gt_frame_wakeup_fd(void);
+void gt_frame_drain_wakeup(void);
+uint64_t gt_now_ns(void);
+
+/* Screen model and output queue */
+
+int gt_screen_resize(int width, int height);
+void gt_screen_free(void);
+int gt_screen_width(void);
+int gt_screen_height(void);
+void gt_screen_put(int x, int y, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
+void gt_screen_blit(int x, int y, int width, int height, const gt_cell_t *cells, size_t stride);
+void gt_screen_fill(int x, int y, int width, int height, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr);
+void gt_screen_invalidate(void);
+void gt_screen_set_cursor(int x, int y);
+void gt_screen_set_cursor_visible(bool visible);
+void gt_screen_set_sync_update(bool enabled);
+void gt_screen_set_repeat(bool enabled);
+void gt_screen_flush(void);
+bool gt_screen_flush_pending(void);
+
+struct gt_mirror *gt_mirror_create(void);
+void gt_mirror_destroy(struct gt_mirror *mirror);
+const char *gt_mirror_update(struct gt_mirror *mirror, size_t *len);
+
+int gt_output_open(int fd);
+void gt_output_close(void);
+int gt_output_fd(void);
+size_t gt_output_pending(void);
+void gt_output_write(const void *data, size_t len);
+void gt_output_puts(const char *str);
+int gt_output_drain(void);
+void gt_output_mark_frame(uint64_t input_ns);
+
+void gt_input_push(const void *data, size_t len);
+
+/* Cell row kernels */
+
+void gt_cells_init(void);
+size_t gt_cells_mismatch(const gt_cell_t *a, const gt_cell_t *b, size_t count);
+uint64_t gt_cells_hash(const gt_cell_t *cells, size_t count);
+
+/* Frame recording. A file starts with GT_RECORD_MAGIC, followed by
+ * records: a type byte, a varint of microseconds since the previous
+ * record, then the payload. Cells are stored as style runs: varint
+ * count, fg, bg, attr bytes, then count characters. tools/gtreplay.c
+ * reads this format. */
+
+#define GT_RECORD_MAGIC "GTREC01\n"
+
+enum {
+    GT_RECORD_KEYFRAME = 1,     // varint width, height; style runs of every cell
+    GT_RECORD_DELTA,            // per row: varint y + 1, then varint x + 1, count and
+                                // style runs, or 0 and the row of the previous frame
+                                // it moved from; a row of 0 ends the frame
+    GT_RECORD_EVENT,            // varint event type, key
+    GT_RECORD_GAP               // records were dropped before this one
+};
+
+void gt_record_frame(const gt_cell_t *cells, const uint64_t *row_hash, int width, int height);
+void gt_record_event(const gt_event_t *event);
+
+/* Screen sharing, served from gt_wait_event() */
+
+void gt_share_frame(void);
+int gt_share_fds(fd_set *readfds, fd_set *writefds, int max_fd);
+void gt_share_handle(const fd_set *readfds, const fd_set *writefds);
+
+/* Render workers, a fixed pool that runs the tasks of one job at a time */
+
+typedef void (*gt_task_fn)(void *arg, int index);
+
+struct gt_workers *gt_workers_create(int threads);
+void gt_workers_destroy(struct gt_workers *workers);
+void gt_workers_run(struct gt_workers *workers, int tasks, gt_task_fn fn, void *arg);
+
+/* Widget internals */
+
+void gt_render_widget(gt_window_t *window, gt_widget_t *widget);
+void gt_console_render(gt_window_t *window, gt_widget_t *widget);
+void gt_console_destroy(gt_widget_t *widget);
+int gt_textbox_init(gt_widget_t *widget, const char *text, int max_length);
+void gt_textbox_set_text(gt_widget_t *widget, const char *text);
+const char *gt_textbox_get_text(gt_widget_t *widget);
+void gt_textbox_render_content(gt_window_t *window, gt_widget_t *widget, int from);
+void gt_textbox_render_damage(gt_window_t *window, gt_widget_t *widget);
+void gt_textbox_destroy(gt_widget_t *widget);
+void gt_viewport_render(gt_window_t *window, gt_widget_t *widget);
+void gt_viewport_render_changed(gt_window_t *window, gt_widget_t *widget);
+void gt_viewport_destroy(gt_widget_t *widget);
+void gt_chart_render(gt_window_t *window, gt_widget_t *widget);
+void gt_chart_render_changed(gt_window_t *window, gt_widget_t *widget);
+void gt_chart_destroy(gt_widget_t *widget);
+void gt_gauge_render(gt_window_t *window, gt_widget_t *widget);
+void gt_gauge_render_changed(gt_window_t *window, gt_widget_t *widget);
+void gt_gauge_destroy(gt_widget_t *widget);
+
 /* IPC Messages */
 
 /* IPC Messages */
@@ -59,9 +313,36 @@ typedef enum {
     GT_IPC_CLEAR_WINDOW,
     GT_IPC_REFRESH_WINDOW,
     GT_IPC_EVENT_KEY,
-    GT_IPC_EVENT_MOUSE
+    GT_IPC_EVENT_MOUSE,
+    GT_IPC_DRAW_CELLS           // a rectangle of cells in the wire format below
 } gt_ipc_msg_type_t;
 
+/* Message data, after the type and window id words. Window ids are
+ * chosen by the client and are unique per client process.
+ *
+ *   GT_IPC_CREATE_WINDOW   struct gt_ipc_geometry, then the title
+ *   GT_IPC_DRAW_CHAR       struct gt_ipc_draw
+ *   GT_IPC_DRAW_STRING     struct gt_ipc_draw up to ch, then the text
+ *   GT_IPC_DRAW_BORDER     fg, bg, attr bytes
+ *   GT_IPC_DRAW_CELLS      a cell span, see src/wire.c
+ *   GT_IPC_EVENT_KEY       int32_t key, from the WM service to the client
+ *   GT_IPC_EVENT_MOUSE     struct gt_ipc_mouse, in window coordinates
+ *   others                 nothing */
+
+struct gt_ipc_geometry {
+    int32_t x, y, width, height;
+};
+
+struct gt_ipc_draw {
+    int32_t x, y;
+    uint8_t fg, bg, attr;
+    char ch;
+};
+
+struct gt_ipc_mouse {
+    int32_t type, x, y, button;     // as in gt_mouse_event_t
+};
+
 // IPC message structure
 typedef struct {
     gt_ipc_msg_type_t type;
@@ -69,4 +350,30 @@ typedef struct {
     uint32_t data_len;
     uint8_t data[];
 } gt_ipc_msg_t;
+
+int gt_ipc_connect_wm(void);
+void gt_ipc_disconnect_wm(void);
+int gt_ipc_send_msg(gt_ipc_msg_type_t type, uint32_t window_id, const void *data, uint32_t data_len);
+int gt_ipc_flush(void);
+int gt_ipc_pending(void);
+int gt_ipc_recv_msg(gt_ipc_msg_t *msg, int timeout);
+int gt_ipc_send_cells(uint32_t window_id, int x, int y, int width, int height, const gt_cell_t *cells, size_t stride);
+
+void gt_ipc_shadow_track(gt_ipc_msg_type_t type, uint32_t window_id, const void *data, uint32_t len);
+void gt_ipc_shadow_blit(uint32_t window_id, int x, int y, int width, int height, const gt_cell_t *cells, size_t stride);
+void gt_ipc_shadow_replay(int (*send)(gt_ipc_msg_type_t, uint32_t, const void *, uint32_t));
+bool gt_ipc_shadow_replay_window(uint32_t window_id, int (*send)(gt_ipc_msg_type_t, uint32_t, const void *, uint32_t));
+void gt_ipc_shadow_clear(void);
+
+/* Cell span wire format, see src/wire.c */
+
+#define GT_WIRE_STYLES_MAX 256
+
+struct gt_wire_span {
+    int x, y, width, height;
+};
+
+size_t gt_wire_cells_bound(size_t count);
+size_t gt_wire_encode_cells(const gt_cell_t *cells, size_t stride, int x, int y, int width, int height, uint8_t *out);
+int gt_wire_decode_cells(const void *data, size_t len, struct gt_wire_span *span, gt_cell_t *cells, size_t cap);
 #endif
\ No newline at end of file
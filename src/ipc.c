@@ -21,34 +21,416 @@
 #include <stdlib.h>
 #include <string.h>
 
-static uint32_t wm_service_pid = 0;
+/*
+ * Messages to the window manager go through a send pipeline and never
+ * block. gt_ipc_send_msg() queues a message; it is sent, with feedback
+ * requested, once fewer than `window` messages are in flight. Messages
+ * in flight are tracked by msg_seq and polled with ipc_get_msg_state()
+ * until the WM service took them. Each message taken earns a credit back,
+ * and a full window of them widens the window by one; a full queue at
+ * the WM halves it, so a congested service gets fewer messages.
+ *
+ * While messages wait, a newer GT_IPC_DRAW_CELLS or GT_IPC_REFRESH_WINDOW
+ * of the same window supersedes the queued ones it covers, so the WM
+ * receives fewer frames but always the latest content. A message that
+ * could not be delivered is not sent again on its own, since newer ones
+ * of its window may have arrived meanwhile: unless newer content that
+ * is waiting replaces it, its window is sent again in full.
+ *
+ * The service's pid is looked up once and checked again every second.
+ * When it is gone or changed (the WM restarted), the queues are dropped
+ * and the lookup is retried with backoff; meanwhile messages only update
+ * the client's copy of its windows (src/ipc_shadow.c). Once the service
+ * is back, each window is created again and sent as one full frame.
+ */
+
+#define GT_IPC_WINDOW_INITIAL 16
+#define GT_IPC_WINDOW_MAX 64
+
+#define GT_IPC_HEALTH_NS 1000000000ull          // between lookups of a connected service
+#define GT_IPC_BACKOFF_MIN_NS 50000000ull       // between lookups while it is gone, doubling
+#define GT_IPC_BACKOFF_MAX_NS 5000000000ull
+
+// ipc_get_msg_state() results; any other value means delivery failed
+#define GT_IPC_STATE_QUEUED 0       // still in the WM service's queue
+#define GT_IPC_STATE_TAKEN 1        // received by the WM service
+
+struct ipc_msg {
+    struct ipc_msg *next;
+    uint64_t seq;
+    gt_ipc_msg_type_t type;
+    uint32_t window_id;
+    struct gt_wire_span span;       // of GT_IPC_DRAW_CELLS
+    size_t len;
+    uint8_t payload[];              // type, window id, then the data
+};
+
+struct ipc_queue {
+    struct ipc_msg *head, *tail;
+    int count;
+};
+
+static bool connected;              // between gt_ipc_connect_wm() and gt_ipc_disconnect_wm()
+static uint32_t wm_service_pid = 0; // 0 while the service is gone
+static uint64_t lookup_ns;          // when to look the service up next
+static uint64_t backoff_ns;
+static struct ipc_queue pending;    // not sent yet, oldest first
+static struct ipc_queue inflight;   // sent, not known to be taken
+static int window = GT_IPC_WINDOW_INITIAL;
+static int acked;                   // messages taken since the window grew
+
+static void queue_push(struct ipc_queue *queue, struct ipc_msg *msg) {
+    msg->next = NULL;
+    if (queue->tail) {
+        queue->tail->next = msg;
+    } else {
+        queue->head = msg;
+    }
+    queue->tail = msg;
+    queue->count++;
+}
+
+// Unlink msg, whose predecessor is prev (NULL for the head)
+static void queue_remove(struct ipc_queue *queue, struct ipc_msg *prev, struct ipc_msg *msg) {
+    if (prev) {
+        prev->next = msg->next;
+    } else {
+        queue->head = msg->next;
+    }
+    if (queue->tail == msg) queue->tail = prev;
+    queue->count--;
+}
+
+static void queue_clear(struct ipc_queue *queue) {
+    while (queue->head) {
+        struct ipc_msg *next = queue->head->next;
+        free(queue->head);
+        queue->head = next;
+    }
+    queue->tail = NULL;
+    queue->count = 0;
+}
+
+static bool span_covers(const struct gt_wire_span *outer, const struct gt_wire_span *inner) {
+    return inner->x >= outer->x && inner->y >= outer->y &&
+           inner->x + inner->width <= outer->x + outer->width &&
+           inner->y + inner->height <= outer->y + outer->height;
+}
+
+static bool coalescable(gt_ipc_msg_type_t type) {
+    return type == GT_IPC_DRAW_CELLS || type == GT_IPC_REFRESH_WINDOW;
+}
+
+// Whether msg is made redundant by newer, which is sent after it
+static bool supersedes(const struct ipc_msg *newer, const struct ipc_msg *msg) {
+    if (newer->window_id != msg->window_id || newer->type != msg->type) return false;
+    return msg->type == GT_IPC_REFRESH_WINDOW || span_covers(&newer->span, &msg->span);
+}
+
+// Drop the queued messages msg supersedes. Any other message for the
+// window, such as a destroy, is a barrier nothing is dropped across
+static void coalesce(struct ipc_msg *msg) {
+    if (!coalescable(msg->type)) return;
+    
+    struct ipc_msg *start = pending.head;
+    for (struct ipc_msg *it = pending.head; it; it = it->next) {
+        if (it->window_id == msg->window_id && !coalescable(it->type)) start = it->next;
+    }
+    
+    struct ipc_msg *prev = NULL;
+    for (struct ipc_msg *it = pending.head; it && it != start; it = it->next) prev = it;
+    struct ipc_msg *it = start;
+    while (it) {
+        struct ipc_msg *next = it->next;
+        if (supersedes(msg, it)) {
+            queue_remove(&pending, prev, it);
+            free(it);
+            gt_ctx()->counters.ipc_messages_coalesced++;
+        } else {
+            prev = it;
+        }
+        it = next;
+    }
+}
+
+static bool superseded_while_pending(const struct ipc_msg *msg) {
+    if (!coalescable(msg->type)) return false;
+    
+    bool superseded = false;
+    for (const struct ipc_msg *it = pending.head; it; it = it->next) {
+        if (it->window_id != msg->window_id) continue;
+        if (!coalescable(it->type)) superseded = false;
+        else if (supersedes(it, msg)) superseded = true;
+    }
+    return superseded;
+}
+
+static struct ipc_msg *make_msg(gt_ipc_msg_type_t type, uint32_t window_id, const void *data, uint32_t data_len);
+
+// Queue a message without tracking it, for replaying the windows
+static int queue_replay(gt_ipc_msg_type_t type, uint32_t window_id, const void *data, uint32_t data_len) {
+    struct ipc_msg *msg = make_msg(type, window_id, data, data_len);
+    if (!msg) return -1;
+    queue_push(&pending, msg);
+    return 0;
+}
+
+static void drop_window(struct ipc_queue *queue, uint32_t window_id) {
+    struct ipc_msg *prev = NULL;
+    struct ipc_msg *msg = queue->head;
+    while (msg) {
+        struct ipc_msg *next = msg->next;
+        if (msg->window_id == window_id) {
+            queue_remove(queue, prev, msg);
+            free(msg);
+        } else {
+            prev = msg;
+        }
+        msg = next;
+    }
+}
+
+// Bring a window the WM service lost a message of up to date. Its newer
+// messages may have been taken already, so sending the lost one again
+// would put old content over new; instead whatever is still queued for
+// the window is dropped and the window is sent again from the client's
+// copy, which the service applies after anything it still holds
+static void resync_window(uint32_t window_id) {
+    drop_window(&pending, window_id);
+    drop_window(&inflight, window_id);
+    if (!gt_ipc_shadow_replay_window(window_id, queue_replay)) {
+        // Gone on our side; make sure it is gone on the service's too
+        queue_replay(GT_IPC_DESTROY_WINDOW, window_id, NULL, 0);
+    }
+}
+
+// Collect the in-flight messages the WM service took or lost. A lost
+// message is dropped if newer content waiting to be sent replaces it,
+// and resyncs its window otherwise
+static void poll_inflight(void) {
+    struct ipc_queue lost = { NULL, NULL, 0 };     // one message per window
+    struct ipc_msg *prev = NULL;
+    struct ipc_msg *msg = inflight.head;
+    
+    while (msg) {
+        struct ipc_msg *next = msg->next;
+        uint8_t state = GT_IPC_STATE_QUEUED;
+        eclib_err_t ret = ipc_get_msg_state(msg->seq, &state);
+        
+        // The service forgets messages once they are taken
+        if (ret == ECLIB_IPC_MSG_NOT_FOUND) state = GT_IPC_STATE_TAKEN;
+        if ((ret != ECLIB_OK && ret != ECLIB_IPC_MSG_NOT_FOUND) || state == GT_IPC_STATE_QUEUED) {
+            prev = msg;
+            msg = next;
+            continue;
+        }
+        
+        queue_remove(&inflight, prev, msg);
+        if (state == GT_IPC_STATE_TAKEN) {
+            free(msg);
+            if (++acked >= window && window < GT_IPC_WINDOW_MAX) {
+                window++;
+                acked = 0;
+            }
+        } else if (superseded_while_pending(msg)) {
+            free(msg);
+            gt_ctx()->counters.ipc_messages_coalesced++;
+        } else {
+            bool known = false;
+            for (const struct ipc_msg *it = lost.head; it && !known; it = it->next) known = it->window_id == msg->window_id;
+            if (known) free(msg);
+            else queue_push(&lost, msg);
+            gt_ctx()->counters.ipc_messages_retried++;
+        }
+        msg = next;
+    }
+    
+    // After the loop, which resyncing would unlink messages under
+    while (lost.head) {
+        msg = lost.head;
+        queue_remove(&lost, NULL, msg);
+        resync_window(msg->window_id);
+        free(msg);
+    }
+}
+
+static void reset_queues(void) {
+    queue_clear(&pending);
+    queue_clear(&inflight);
+    window = GT_IPC_WINDOW_INITIAL;
+    acked = 0;
+}
+
+// What was sent to the old service is lost with it
+static void connection_lost(void) {
+    wm_service_pid = 0;
+    reset_queues();
+    lookup_ns = gt_now_ns();
+    backoff_ns = GT_IPC_BACKOFF_MIN_NS;
+}
+
+// Whether the service can be sent to now. Looks it up when due, and
+// replays the windows to a service that came back
+static bool check_connection(void) {
+    uint64_t now = gt_now_ns();
+    if (now < lookup_ns) return wm_service_pid != 0;
+    
+    uint32_t pid = eclib_service_lookup("window_manager");
+    if (pid != 0 && pid == wm_service_pid) {
+        lookup_ns = now + GT_IPC_HEALTH_NS;
+        return true;
+    }
+    if (pid == 0) {
+        if (wm_service_pid != 0) connection_lost();
+        lookup_ns = now + backoff_ns;
+        backoff_ns = backoff_ns * 2 < GT_IPC_BACKOFF_MAX_NS ? backoff_ns * 2 : GT_IPC_BACKOFF_MAX_NS;
+        return false;
+    }
+    
+    // A new service knows nothing of our windows
+    reset_queues();
+    wm_service_pid = pid;
+    lookup_ns = now + GT_IPC_HEALTH_NS;
+    backoff_ns = GT_IPC_BACKOFF_MIN_NS;
+    gt_ipc_shadow_replay(queue_replay);
+    gt_ctx()->counters.ipc_reconnects++;
+    return true;
+}
+
+// Send queued messages while the window has room
+static void pump(void) {
+    if (!check_connection()) return;
+    poll_inflight();
+    
+    while (pending.head && inflight.count < window) {
+        struct ipc_msg *msg = pending.head;
+        GT_TRACE_BEGIN(start);
+        eclib_err_t ret = ipc_send_msg(wm_service_pid, (uint16_t)msg->type, msg->payload, msg->len, 1, &msg->seq);
+        GT_TRACE_END(start, "ipc_send");
+        
+        switch (ret) {
+            case ECLIB_OK:
+                queue_remove(&pending, NULL, msg);
+                queue_push(&inflight, msg);
+                gt_ctx()->counters.ipc_messages_sent++;
+                gt_ctx()->counters.ipc_bytes_sent += msg->len;
+                break;
+            case ECLIB_IPC_MSG_QUEUE_FULL:
+                // Back off; what is in flight has to drain first
+                window = window > 1 ? window / 2 : 1;
+                acked = 0;
+                return;
+            case ECLIB_IPC_TIMEOUT:
+                return;
+            case ECLIB_IPC_SERVICE_UNAVAIL:
+            case ECLIB_IPC_CONNECTION_LOST:
+            case ECLIB_IPC_INVALID_ENDPOINT:
+                gt_ctx()->counters.ipc_send_errors++;
+                connection_lost();
+                return;
+            default:
+                // The message itself is bad, sending it again cannot help
+                queue_remove(&pending, NULL, msg);
+                free(msg);
+                gt_ctx()->counters.ipc_send_errors++;
+                break;
+        }
+    }
+}
 
 int gt_ipc_connect_wm(void) {
     wm_service_pid = eclib_service_lookup("window_manager");
-    return wm_service_pid > 0 ? 0 : -1;
+    if (wm_service_pid == 0) return -1;
+    
+    connected = true;
+    lookup_ns = gt_now_ns() + GT_IPC_HEALTH_NS;
+    backoff_ns = GT_IPC_BACKOFF_MIN_NS;
+    return 0;
 }
 
 void gt_ipc_disconnect_wm(void) {
+    connected = false;
     wm_service_pid = 0;
+    reset_queues();
+    gt_ipc_shadow_clear();
 }
 
-int gt_ipc_send_msg(gt_ipc_msg_type_t type, uint32_t window_id, const void *data, uint32_t data_len) {
-    if (wm_service_pid == 0) return -1;
-    
+static struct ipc_msg *make_msg(gt_ipc_msg_type_t type, uint32_t window_id, const void *data, uint32_t data_len) {
     size_t total_size = sizeof(uint32_t) + sizeof(uint32_t) + data_len;
-    uint8_t *payload = malloc(total_size);
-    if (!payload) return -1;
+    struct ipc_msg *msg = gt_malloc(sizeof(struct ipc_msg) + total_size);
+    if (!msg) return NULL;
     
-    memcpy(payload, &type, sizeof(uint32_t));
-    memcpy(payload + sizeof(uint32_t), &window_id, sizeof(uint32_t));
+    uint32_t type_id = (uint32_t)type;
+    memcpy(msg->payload, &type_id, sizeof(uint32_t));
+    memcpy(msg->payload + sizeof(uint32_t), &window_id, sizeof(uint32_t));
     if (data && data_len > 0) {
-        memcpy(payload + sizeof(uint32_t) * 2, data, data_len);
+        memcpy(msg->payload + sizeof(uint32_t) * 2, data, data_len);
+    }
+    msg->seq = 0;
+    msg->type = type;
+    msg->window_id = window_id;
+    msg->len = total_size;
+    memset(&msg->span, 0, sizeof(msg->span));
+    if (type == GT_IPC_DRAW_CELLS && (!data || gt_wire_decode_cells(data, data_len, &msg->span, NULL, 0) != 0)) {
+        free(msg);
+        gt_ctx()->counters.ipc_send_errors++;
+        return NULL;
     }
+    return msg;
+}
+
+// Queue a message already applied to the window copies
+static int queue_msg(gt_ipc_msg_type_t type, uint32_t window_id, const void *data, uint32_t data_len) {
+    // While the service is gone, the window copies hold what it missed
+    // and are replayed once it is back
+    if (wm_service_pid == 0) {
+        pump();
+        return 0;
+    }
+    
+    struct ipc_msg *msg = make_msg(type, window_id, data, data_len);
+    if (!msg) return -1;
+    
+    coalesce(msg);
+    queue_push(&pending, msg);
+    pump();
+    return 0;
+}
+
+// Queue a message for the WM service. Returns 0 once it is queued, or
+// kept for a service that restarts; -1 if not connected or it is bad
+int gt_ipc_send_msg(gt_ipc_msg_type_t type, uint32_t window_id, const void *data, uint32_t data_len) {
+    if (!connected) return -1;
+    
+    gt_ipc_shadow_track(type, window_id, data, data_len);
+    return queue_msg(type, window_id, data, data_len);
+}
+
+// Send what the window allows now; call while messages are queued
+int gt_ipc_flush(void) {
+    if (!connected) return -1;
+    pump();
+    return 0;
+}
+
+// Messages queued or not yet taken by the WM service. A client can skip
+// producing frames while this stays high
+int gt_ipc_pending(void) {
+    return pending.count + inflight.count;
+}
+
+// Window content as one GT_IPC_DRAW_CELLS message, run-length encoded
+int gt_ipc_send_cells(uint32_t window_id, int x, int y, int width, int height, const gt_cell_t *cells, size_t stride) {
+    if (!connected || !cells || width <= 0 || height <= 0) return -1;
+    gt_ipc_shadow_blit(window_id, x, y, width, height, cells, stride);
     
-    eclib_err_t ret = ipc_send_msg(wm_service_pid, type, payload, total_size, 0, NULL);
-    free(payload);
+    uint8_t *data = gt_malloc(gt_wire_cells_bound((size_t)width * (size_t)height));
+    if (!data) return -1;
     
-    return ret == ECLIB_OK ? 0 : -1;
+    size_t len = gt_wire_encode_cells(cells, stride, x, y, width, height, data);
+    int ret = len > 0 && len <= UINT32_MAX ? queue_msg(GT_IPC_DRAW_CELLS, window_id, data, (uint32_t)len) : -1;
+    free(data);
+    return ret;
 }
 
 int gt_ipc_recv_msg(gt_ipc_msg_t *msg, int timeout) {
@@ -0,0 +1,226 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The client's copy of its windows in the WM service: the data each one
+ * was created with, and its content as drawn through IPC. When the
+ * service restarts, every window is created again and sent as one full
+ * frame, so the application does not have to redraw anything.
+ */
+
+struct shadow_window {
+    struct shadow_window *next;
+    uint32_t id;
+    int width, height;
+    gt_cell_t *cells;
+    uint32_t create_len;
+    uint8_t create[];               // GT_IPC_CREATE_WINDOW data
+};
+
+static struct shadow_window *windows;   // oldest first, as they are stacked
+
+static const gt_cell_t blank = { ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+
+static struct shadow_window *find(uint32_t id) {
+    for (struct shadow_window *win = windows; win; win = win->next) {
+        if (win->id == id) return win;
+    }
+    return NULL;
+}
+
+static void forget(uint32_t id) {
+    struct shadow_window **link = &windows;
+    while (*link && (*link)->id != id) link = &(*link)->next;
+    if (!*link) return;
+
+    struct shadow_window *win = *link;
+    *link = win->next;
+    free(win->cells);
+    free(win);
+}
+
+static void create(uint32_t id, const uint8_t *data, uint32_t len) {
+    struct gt_ipc_geometry geometry;
+    forget(id);
+    if (len < sizeof(geometry)) return;
+    memcpy(&geometry, data, sizeof(geometry));
+    if (geometry.width <= 0 || geometry.height <= 0 || geometry.width > 65535 || geometry.height > 65535) return;
+
+    struct shadow_window *win = gt_malloc(sizeof(*win) + len);
+    size_t count = (size_t)geometry.width * (size_t)geometry.height;
+    gt_cell_t *cells = win ? gt_malloc(count * sizeof(gt_cell_t)) : NULL;
+    if (!cells) {
+        free(win);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) cells[i] = blank;
+
+    win->next = NULL;
+    win->id = id;
+    win->width = geometry.width;
+    win->height = geometry.height;
+    win->cells = cells;
+    win->create_len = len;
+    memcpy(win->create, data, len);
+
+    struct shadow_window **link = &windows;
+    while (*link) link = &(*link)->next;
+    *link = win;
+}
+
+// Fill a rectangle of the window, clipped to it, as the WM service does
+static void fill(struct shadow_window *win, int x, int y, int width, int height, gt_cell_t cell) {
+    if (x < 0) { width += x; x = 0; }
+    if (y < 0) { height += y; y = 0; }
+    if (x + width > win->width) width = win->width - x;
+    if (y + height > win->height) height = win->height - y;
+
+    for (int row = y; row < y + height; row++) {
+        gt_cell_t *dst = &win->cells[(size_t)row * (size_t)win->width];
+        for (int col = x; col < x + width; col++) dst[col] = cell;
+    }
+}
+
+static void blit(struct shadow_window *win, int x, int y, int width, int height, const gt_cell_t *cells, size_t stride) {
+    int left = x < 0 ? -x : 0;
+    int top = y < 0 ? -y : 0;
+    if (x + width > win->width) width = win->width - x;
+    if (y + height > win->height) height = win->height - y;
+
+    for (int row = top; row < height; row++) {
+        for (int col = left; col < width; col++) {
+            win->cells[(size_t)(y + row) * (size_t)win->width + (size_t)(x + col)] = cells[(size_t)row * stride + (size_t)col];
+        }
+    }
+}
+
+static void draw_border(struct shadow_window *win, gt_cell_t cell) {
+    cell.ch = '-';
+    fill(win, 0, 0, win->width, 1, cell);
+    fill(win, 0, win->height - 1, win->width, 1, cell);
+    cell.ch = '|';
+    fill(win, 0, 0, 1, win->height, cell);
+    fill(win, win->width - 1, 0, 1, win->height, cell);
+    cell.ch = '+';
+    fill(win, 0, 0, 1, 1, cell);
+    fill(win, win->width - 1, 0, 1, 1, cell);
+    fill(win, 0, win->height - 1, 1, 1, cell);
+    fill(win, win->width - 1, win->height - 1, 1, 1, cell);
+}
+
+static void draw_cells(struct shadow_window *win, const uint8_t *data, uint32_t len) {
+    struct gt_wire_span span;
+    if (gt_wire_decode_cells(data, len, &span, NULL, 0) != 0) return;
+
+    size_t count = (size_t)span.width * (size_t)span.height;
+    gt_cell_t *cells = gt_malloc(count * sizeof(gt_cell_t));
+    if (!cells) return;
+    if (gt_wire_decode_cells(data, len, &span, cells, count) == 0) {
+        blit(win, span.x, span.y, span.width, span.height, cells, (size_t)span.width);
+    }
+    free(cells);
+}
+
+// Apply a message about to be sent to the copy of its window
+void gt_ipc_shadow_track(gt_ipc_msg_type_t type, uint32_t window_id, const void *data, uint32_t len) {
+    const uint8_t *bytes = data;
+    if (type == GT_IPC_CREATE_WINDOW) {
+        create(window_id, bytes, data ? len : 0);
+        return;
+    }
+    if (type == GT_IPC_DESTROY_WINDOW) {
+        forget(window_id);
+        return;
+    }
+
+    struct shadow_window *win = find(window_id);
+    if (!win) return;
+
+    struct gt_ipc_draw draw;
+    gt_cell_t cell = blank;
+    switch (type) {
+        case GT_IPC_DRAW_CHAR:
+            if (len < sizeof(draw)) return;
+            memcpy(&draw, bytes, sizeof(draw));
+            cell = (gt_cell_t){ draw.ch, draw.fg, draw.bg, draw.attr };
+            fill(win, draw.x, draw.y, 1, 1, cell);
+            break;
+        case GT_IPC_DRAW_STRING:
+            if (len < offsetof(struct gt_ipc_draw, ch)) return;
+            memcpy(&draw, bytes, offsetof(struct gt_ipc_draw, ch));
+            cell = (gt_cell_t){ ' ', draw.fg, draw.bg, draw.attr };
+            for (size_t i = offsetof(struct gt_ipc_draw, ch); i < len && bytes[i]; i++) {
+                cell.ch = (char)bytes[i];
+                fill(win, draw.x++, draw.y, 1, 1, cell);
+            }
+            break;
+        case GT_IPC_DRAW_BORDER:
+            if (len < 3) return;
+            draw_border(win, (gt_cell_t){ ' ', bytes[0], bytes[1], bytes[2] });
+            break;
+        case GT_IPC_CLEAR_WINDOW:
+            fill(win, 0, 0, win->width, win->height, blank);
+            break;
+        case GT_IPC_DRAW_CELLS:
+            draw_cells(win, bytes, len);
+            break;
+        default:
+            break;
+    }
+}
+
+// As gt_ipc_shadow_track() for a span of cells, without decoding it
+void gt_ipc_shadow_blit(uint32_t window_id, int x, int y, int width, int height, const gt_cell_t *cells, size_t stride) {
+    struct shadow_window *win = find(window_id);
+    if (win) blit(win, x, y, width, height, cells, stride);
+}
+
+static void replay(struct shadow_window *win, int (*send)(gt_ipc_msg_type_t, uint32_t, const void *, uint32_t)) {
+    send(GT_IPC_CREATE_WINDOW, win->id, win->create, win->create_len);
+
+    uint8_t *data = gt_malloc(gt_wire_cells_bound((size_t)win->width * (size_t)win->height));
+    if (data) {
+        size_t len = gt_wire_encode_cells(win->cells, (size_t)win->width, 0, 0, win->width, win->height, data);
+        if (len > 0 && len <= UINT32_MAX) send(GT_IPC_DRAW_CELLS, win->id, data, (uint32_t)len);
+        free(data);
+    }
+    send(GT_IPC_REFRESH_WINDOW, win->id, NULL, 0);
+}
+
+// Send every window again through send: its create message, then all of
+// it as one GT_IPC_DRAW_CELLS frame, and a refresh
+void gt_ipc_shadow_replay(int (*send)(gt_ipc_msg_type_t, uint32_t, const void *, uint32_t)) {
+    for (struct shadow_window *win = windows; win; win = win->next) replay(win, send);
+}
+
+// The same for one window. False if there is no such window, as after
+// it was destroyed
+bool gt_ipc_shadow_replay_window(uint32_t window_id, int (*send)(gt_ipc_msg_type_t, uint32_t, const void *, uint32_t)) {
+    struct shadow_window *win = find(window_id);
+    if (!win) return false;
+    replay(win, send);
+    return true;
+}
+
+void gt_ipc_shadow_clear(void) {
+    while (windows) forget(windows->id);
+}
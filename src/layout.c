@@ -0,0 +1,476 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Flex layout. A window owns a tree of layout nodes; containers place
+ * their children along a main axis (rows, columns), on top of each other
+ * (stacks) or by a fixed ratio (splits), and leaves move their widget.
+ *
+ * Every node caches its preferred size and the rectangle it was given
+ * last time. A change marks the node and its ancestors dirty; relayout
+ * then skips every clean subtree whose rectangle did not change, and a
+ * clean subtree that only moved is translated without being solved.
+ */
+
+#define GT_LAYOUT_SPLIT_DEFAULT 500     // per mille of the first pane
+
+struct gt_layout {
+    gt_layout_type_t type;
+    gt_widget_t *widget;            // leaves only
+    gt_window_t *window;            // root only
+    struct gt_layout *parent;
+    struct gt_layout *children, *last_child;
+    struct gt_layout *next;
+
+    // Constraints
+    int grow;
+    int basis;                      // main axis size, -1 is the preferred size
+    int hint_w, hint_h;             // preferred size of a leaf, -1 from the widget
+    int min_w, min_h;
+    int max_w, max_h;               // 0 means unbounded
+    int padding;
+    int gap;
+    int split;
+
+    // Cache
+    bool dirty;                     // this subtree has to be solved again
+    bool measured;
+    int pref_w, pref_h;
+    bool placed;
+    int x, y, w, h;
+    int span;                       // main axis size while the parent solves
+};
+
+// Bounding box of the cells vacated by moved widgets during one update
+struct layout_damage {
+    int x0, y0, x1, y1;
+};
+
+static gt_layout_t *layout_alloc(gt_layout_type_t type) {
+    gt_layout_t *node = gt_malloc(sizeof(gt_layout_t));
+    if (!node) return NULL;
+
+    memset(node, 0, sizeof(gt_layout_t));
+    node->type = type;
+    node->basis = -1;
+    node->hint_w = node->hint_h = -1;
+    node->split = GT_LAYOUT_SPLIT_DEFAULT;
+    node->dirty = true;
+    return node;
+}
+
+static void layout_mark(gt_layout_t *node) {
+    // Stop at the first ancestor that is already marked
+    for (; node; node = node->parent) {
+        if (node->dirty && !node->measured) break;
+        node->dirty = true;
+        node->measured = false;
+        if (node->window) gt_request_frame();
+    }
+}
+
+static void layout_append(gt_layout_t *parent, gt_layout_t *child) {
+    child->parent = parent;
+    child->next = NULL;
+    if (parent->last_child) {
+        parent->last_child->next = child;
+    } else {
+        parent->children = child;
+    }
+    parent->last_child = child;
+    layout_mark(parent);
+}
+
+gt_layout_t *gt_create_layout(gt_layout_type_t type) {
+    if (type == GT_LAYOUT_WIDGET) return NULL;
+    return layout_alloc(type);
+}
+
+gt_layout_t *gt_layout_add_widget(gt_layout_t *parent, gt_widget_t *widget) {
+    if (!parent || parent->type == GT_LAYOUT_WIDGET || !widget || widget->layout) return NULL;
+
+    gt_layout_t *leaf = layout_alloc(GT_LAYOUT_WIDGET);
+    if (!leaf) return NULL;
+
+    // A label's preferred size follows its text, others keep their size
+    leaf->widget = widget;
+    if (widget->type != GT_WIDGET_LABEL) {
+        leaf->hint_w = widget->width;
+        leaf->hint_h = widget->height;
+    }
+    widget->layout = leaf;
+    layout_append(parent, leaf);
+    return leaf;
+}
+
+int gt_layout_add_child(gt_layout_t *parent, gt_layout_t *child) {
+    if (!parent || parent->type == GT_LAYOUT_WIDGET || !child) return -1;
+    if (child->parent || child->window) return -1;
+
+    for (gt_layout_t *node = parent; node; node = node->parent) {
+        if (node == child) return -1;
+    }
+    layout_append(parent, child);
+    return 0;
+}
+
+static void layout_free(gt_layout_t *node) {
+    gt_layout_t *child = node->children;
+    while (child) {
+        gt_layout_t *next = child->next;
+        layout_free(child);
+        child = next;
+    }
+    if (node->widget) node->widget->layout = NULL;
+    free(node);
+}
+
+void gt_destroy_layout(gt_layout_t *node) {
+    if (!node) return;
+
+    if (node->parent) {
+        gt_layout_t *parent = node->parent;
+        gt_layout_t *prev = NULL;
+        for (gt_layout_t *child = parent->children; child; prev = child, child = child->next) {
+            if (child != node) continue;
+            if (prev) {
+                prev->next = child->next;
+            } else {
+                parent->children = child->next;
+            }
+            if (parent->last_child == child) parent->last_child = prev;
+            break;
+        }
+        layout_mark(parent);
+    }
+    if (node->window) node->window->layout = NULL;
+    layout_free(node);
+}
+
+void gt_layout_set_flex(gt_layout_t *node, int grow, int basis) {
+    if (!node) return;
+    node->grow = grow > 0 ? grow : 0;
+    node->basis = basis >= 0 ? basis : -1;
+    layout_mark(node);
+}
+
+void gt_layout_set_size_hint(gt_layout_t *node, int width, int height) {
+    if (!node) return;
+    node->hint_w = width >= 0 ? width : -1;
+    node->hint_h = height >= 0 ? height : -1;
+    layout_mark(node);
+}
+
+void gt_layout_set_min_size(gt_layout_t *node, int width, int height) {
+    if (!node) return;
+    node->min_w = width > 0 ? width : 0;
+    node->min_h = height > 0 ? height : 0;
+    layout_mark(node);
+}
+
+void gt_layout_set_max_size(gt_layout_t *node, int width, int height) {
+    if (!node) return;
+    node->max_w = width > 0 ? width : 0;
+    node->max_h = height > 0 ? height : 0;
+    layout_mark(node);
+}
+
+void gt_layout_set_padding(gt_layout_t *node, int padding) {
+    if (!node) return;
+    node->padding = padding > 0 ? padding : 0;
+    layout_mark(node);
+}
+
+void gt_layout_set_gap(gt_layout_t *node, int gap) {
+    if (!node) return;
+    node->gap = gap > 0 ? gap : 0;
+    layout_mark(node);
+}
+
+void gt_layout_set_split(gt_layout_t *node, int per_mille) {
+    if (!node) return;
+    if (per_mille < 0) per_mille = 0;
+    if (per_mille > 1000) per_mille = 1000;
+    node->split = per_mille;
+    layout_mark(node);
+}
+
+void gt_get_layout_geometry(gt_layout_t *node, int *x, int *y, int *width, int *height) {
+    if (!node) return;
+    if (x) *x = node->x;
+    if (y) *y = node->y;
+    if (width) *width = node->w;
+    if (height) *height = node->h;
+}
+
+void gt_set_window_layout(gt_window_t *window, gt_layout_t *root) {
+    if (!window || (root && (root->parent || root->window))) return;
+
+    if (window->layout) window->layout->window = NULL;
+    window->layout = root;
+    if (root) {
+        root->window = window;
+        root->placed = false;
+        layout_mark(root);
+        gt_request_frame();
+    }
+}
+
+void gt_layout_widget_changed(gt_widget_t *widget) {
+    if (widget && widget->layout) layout_mark(widget->layout);
+}
+
+// The leaf keeps its place, it just has nothing to move any more
+void gt_layout_widget_destroyed(gt_widget_t *widget) {
+    if (!widget || !widget->layout) return;
+    widget->layout->widget = NULL;
+    layout_mark(widget->layout);
+    widget->layout = NULL;
+}
+
+static bool layout_horizontal(const gt_layout_t *node) {
+    return node->type == GT_LAYOUT_ROW || node->type == GT_LAYOUT_HSPLIT;
+}
+
+static int clamp_size(int size, int min, int max) {
+    if (max > 0 && size > max) size = max;
+    if (size < min) size = min;
+    return size < 0 ? 0 : size;
+}
+
+static void layout_measure(gt_layout_t *node) {
+    if (node->measured) return;
+
+    int w = 0, h = 0;
+    if (node->type == GT_LAYOUT_WIDGET) {
+        const gt_widget_t *widget = node->widget;
+        w = node->hint_w;
+        h = node->hint_h;
+        if (w < 0) w = widget && widget->text ? (int)strlen(widget->text) : 0;
+        if (h < 0) h = 1;
+    } else {
+        bool horizontal = layout_horizontal(node);
+        bool stacked = node->type == GT_LAYOUT_STACK;
+        int count = 0;
+
+        for (gt_layout_t *child = node->children; child; child = child->next) {
+            layout_measure(child);
+            int cw = child->pref_w, ch = child->pref_h;
+            if (!stacked && child->basis >= 0) {
+                if (horizontal) cw = child->basis; else ch = child->basis;
+            }
+            if (stacked) {
+                if (cw > w) w = cw;
+                if (ch > h) h = ch;
+            } else if (horizontal) {
+                w += cw;
+                if (ch > h) h = ch;
+            } else {
+                h += ch;
+                if (cw > w) w = cw;
+            }
+            count++;
+        }
+        if (!stacked && count > 1) {
+            if (horizontal) w += node->gap * (count - 1); else h += node->gap * (count - 1);
+        }
+        w += 2 * node->padding;
+        h += 2 * node->padding;
+    }
+
+    node->pref_w = clamp_size(w, node->min_w, node->max_w);
+    node->pref_h = clamp_size(h, node->min_h, node->max_h);
+    node->measured = true;
+}
+
+static void damage_add(struct layout_damage *damage, int x, int y, int w, int h) {
+    if (w <= 0 || h <= 0) return;
+    if (damage->x1 <= damage->x0) {
+        damage->x0 = x;
+        damage->y0 = y;
+        damage->x1 = x + w;
+        damage->y1 = y + h;
+        return;
+    }
+    if (x < damage->x0) damage->x0 = x;
+    if (y < damage->y0) damage->y0 = y;
+    if (x + w > damage->x1) damage->x1 = x + w;
+    if (y + h > damage->y1) damage->y1 = y + h;
+}
+
+static void layout_move_widget(gt_layout_t *leaf, struct layout_damage *damage) {
+    gt_widget_t *widget = leaf->widget;
+    if (!widget) return;
+    if (widget->x == leaf->x && widget->y == leaf->y &&
+        widget->width == leaf->w && widget->height == leaf->h) return;
+
+    damage_add(damage, widget->x, widget->y, widget->width, widget->height);
+    widget->x = leaf->x;
+    widget->y = leaf->y;
+    widget->width = leaf->w;
+    widget->height = leaf->h;
+    gt_invalidate_widget(widget);
+}
+
+static void layout_translate(gt_layout_t *node, int dx, int dy, struct layout_damage *damage) {
+    node->x += dx;
+    node->y += dy;
+    if (node->type == GT_LAYOUT_WIDGET) layout_move_widget(node, damage);
+    for (gt_layout_t *child = node->children; child; child = child->next) {
+        layout_translate(child, dx, dy, damage);
+    }
+}
+
+// Split `space` along the main axis, growing or shrinking the preferred sizes
+static void layout_distribute(gt_layout_t *node, bool horizontal, int space) {
+    int used = 0, grow = 0, slack = 0;
+
+    for (gt_layout_t *child = node->children; child; child = child->next) {
+        int base = child->basis >= 0 ? child->basis : (horizontal ? child->pref_w : child->pref_h);
+        int min = horizontal ? child->min_w : child->min_h;
+        int max = horizontal ? child->max_w : child->max_h;
+        child->span = clamp_size(base, min, max);
+        used += child->span;
+        grow += child->grow;
+        slack += child->span - min;
+    }
+
+    int free_space = space - used;
+    if (free_space > 0 && grow > 0) {
+        int left = free_space;
+        for (gt_layout_t *child = node->children; child; child = child->next) {
+            if (child->grow == 0) continue;
+            grow -= child->grow;
+            int add = grow == 0 ? left : (int)((long long)free_space * child->grow / (grow + child->grow));
+            if (add > left) add = left;
+            int max = horizontal ? child->max_w : child->max_h;
+            int span = clamp_size(child->span + add, 0, max);
+            left -= span - child->span;
+            free_space -= span - child->span;
+            child->span = span;
+        }
+    } else if (free_space < 0 && slack > 0) {
+        // Shrink in proportion to how far each child is above its minimum
+        int deficit = -free_space;
+        for (gt_layout_t *child = node->children; child; child = child->next) {
+            int min = horizontal ? child->min_w : child->min_h;
+            int room = child->span - min;
+            if (room <= 0) continue;
+            int cut = slack == room ? deficit : (int)((long long)deficit * room / slack);
+            if (cut > room) cut = room;
+            slack -= room;
+            deficit -= cut;
+            child->span -= cut;
+        }
+    }
+}
+
+static void layout_solve(gt_layout_t *node, int x, int y, int w, int h, struct layout_damage *damage);
+
+static void layout_place_children(gt_layout_t *node, struct layout_damage *damage) {
+    int pad = node->padding;
+    int ix = node->x + pad, iy = node->y + pad;
+    int iw = node->w - 2 * pad, ih = node->h - 2 * pad;
+    if (iw < 0) iw = 0;
+    if (ih < 0) ih = 0;
+
+    if (node->type == GT_LAYOUT_STACK) {
+        for (gt_layout_t *child = node->children; child; child = child->next) {
+            layout_solve(child, ix, iy, clamp_size(iw, 0, child->max_w), clamp_size(ih, 0, child->max_h), damage);
+        }
+        return;
+    }
+
+    bool horizontal = layout_horizontal(node);
+    int main = horizontal ? iw : ih;
+    int count = 0;
+    for (gt_layout_t *child = node->children; child; child = child->next) count++;
+    int space = main - (count > 1 ? node->gap * (count - 1) : 0);
+    if (space < 0) space = 0;
+
+    if (node->type == GT_LAYOUT_HSPLIT || node->type == GT_LAYOUT_VSPLIT) {
+        // The first pane takes its share, the others split the rest evenly
+        int first = (int)((long long)space * node->split / 1000);
+        int rest = count > 1 ? (space - first) / (count - 1) : 0;
+        int extra = count > 1 ? (space - first) % (count - 1) : 0;
+        for (gt_layout_t *child = node->children; child; child = child->next) {
+            child->span = child == node->children ? first : rest + (child->next ? 0 : extra);
+        }
+        if (count == 1) node->children->span = space;
+    } else {
+        layout_distribute(node, horizontal, space);
+    }
+
+    int pos = horizontal ? ix : iy;
+    for (gt_layout_t *child = node->children; child; child = child->next) {
+        if (horizontal) {
+            layout_solve(child, pos, iy, child->span, clamp_size(ih, 0, child->max_h), damage);
+        } else {
+            layout_solve(child, ix, pos, clamp_size(iw, 0, child->max_w), child->span, damage);
+        }
+        pos += child->span + node->gap;
+    }
+}
+
+static void layout_solve(gt_layout_t *node, int x, int y, int w, int h, struct layout_damage *damage) {
+    if (node->placed && !node->dirty && node->w == w && node->h == h) {
+        if (node->x != x || node->y != y) layout_translate(node, x - node->x, y - node->y, damage);
+        return;
+    }
+
+    node->x = x;
+    node->y = y;
+    node->w = w;
+    node->h = h;
+    node->placed = true;
+    node->dirty = false;
+
+    if (node->type == GT_LAYOUT_WIDGET) {
+        layout_move_widget(node, damage);
+    } else {
+        for (gt_layout_t *child = node->children; child; child = child->next) layout_measure(child);
+        layout_place_children(node, damage);
+    }
+}
+
+// Lay the window out again if its size or any constraint changed
+void gt_layout_update(gt_window_t *window) {
+    gt_layout_t *root = window->layout;
+    if (!root) return;
+    if (root->placed && !root->dirty && root->w == window->width && root->h == window->height) return;
+
+    struct layout_damage damage = { 0, 0, 0, 0 };
+    GT_TRACE_BEGIN(start);
+    layout_solve(root, 0, 0, window->width, window->height, &damage);
+    GT_TRACE_END(start, "layout");
+
+    if (damage.x1 <= damage.x0) return;
+
+    // Blank what moved widgets left behind and repaint whatever was under it
+    gt_fill_rect(window, damage.x0, damage.y0, damage.x1 - damage.x0, damage.y1 - damage.y0,
+                 ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    for (gt_widget_t *widget = window->widgets; widget; widget = widget->next) {
+        if (widget->x < damage.x1 && widget->x + widget->width > damage.x0 &&
+            widget->y < damage.y1 && widget->y + widget->height > damage.y0) {
+            gt_invalidate_widget(widget);
+        }
+    }
+}
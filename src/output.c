@@ -0,0 +1,158 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/select.h>
+
+/*
+ * Output queue. Everything GTlib sends to the terminal is appended here
+ * and written with non-blocking write() calls, so a slow tty never
+ * stalls input handling; gt_wait_event() drains the rest when the fd
+ * becomes writable again.
+ *
+ * On a tty the fd's flags are shared with stdin and with the
+ * application's stdio, which would see EAGAIN if O_NONBLOCK stayed set.
+ * It is only set while GTlib itself writes.
+ */
+
+int gt_output_open(int fd) {
+    struct gt_output *out = &gt_ctx()->output;
+    out->fd = fd;
+    out->len = out->off = 0;
+    out->mark_input_ns = 0;
+
+    out->saved_flags = fcntl(fd, F_GETFL);
+    return out->saved_flags < 0 ? -1 : 0;
+}
+
+static void output_set_nonblocking(const struct gt_output *out, bool on) {
+    if (out->saved_flags < 0 || (out->saved_flags & O_NONBLOCK)) return;
+    fcntl(out->fd, F_SETFL, on ? out->saved_flags | O_NONBLOCK : out->saved_flags);
+}
+
+// Write out whatever is left, blocking
+void gt_output_close(void) {
+    struct gt_output *out = &gt_ctx()->output;
+    if (out->fd < 0) return;
+
+    while (gt_output_drain() > 0) {
+        fd_set writefds;
+        FD_ZERO(&writefds);
+        FD_SET(out->fd, &writefds);
+        if (select(out->fd + 1, NULL, &writefds, NULL, NULL) < 0 && errno != EINTR) break;
+    }
+
+    free(out->buf);
+    out->buf = NULL;
+    out->cap = out->len = out->off = 0;
+    out->fd = -1;
+}
+
+int gt_output_fd(void) {
+    return gt_ctx()->output.fd;
+}
+
+size_t gt_output_pending(void) {
+    struct gt_output *out = &gt_ctx()->output;
+    return out->len - out->off;
+}
+
+void gt_output_write(const void *data, size_t len) {
+    struct gt_output *out = &gt_ctx()->output;
+    if (out->fd < 0 || len == 0) return;
+
+    // Reclaim the already written prefix before growing
+    if (out->off > 0 && out->len + len > out->cap) {
+        memmove(out->buf, out->buf + out->off, out->len - out->off);
+        out->len -= out->off;
+        out->off = 0;
+    }
+    if (out->len + len > out->cap) {
+        size_t cap = out->cap ? out->cap * 2 : 4096;
+        while (cap < out->len + len) cap *= 2;
+        char *buf = gt_realloc(out->buf, cap);
+        if (!buf) {
+            // The terminal misses part of a frame, so repaint all of it
+            gt_screen_invalidate();
+            gt_request_frame();
+            return;
+        }
+        out->buf = buf;
+        out->cap = cap;
+    }
+
+    memcpy(out->buf + out->len, data, len);
+    out->len += len;
+}
+
+void gt_output_puts(const char *str) {
+    gt_output_write(str, strlen(str));
+}
+
+// The frame just queued answers a key decoded at `input_ns`; its latency
+// is recorded once the last byte queued so far has been written
+void gt_output_mark_frame(uint64_t input_ns) {
+    struct gt_output *out = &gt_ctx()->output;
+    out->mark_left = out->len - out->off;
+    out->mark_input_ns = input_ns;
+}
+
+// Returns the number of bytes still queued, or -1 on a write error
+int gt_output_drain(void) {
+    struct gt_output *out = &gt_ctx()->output;
+    if (out->off == out->len) return 0;
+
+    output_set_nonblocking(out, true);
+    while (out->off < out->len) {
+        GT_TRACE_BEGIN(start);
+        ssize_t n = write(out->fd, out->buf + out->off, out->len - out->off);
+        GT_TRACE_END(start, "write");
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            // The terminal missed cells front already holds; should the
+            // error pass, the next frame repaints everything
+            output_set_nonblocking(out, false);
+            out->len = out->off = 0;
+            out->mark_input_ns = 0;
+            gt_screen_invalidate();
+            gt_request_frame();
+            return -1;
+        }
+        out->off += (size_t)n;
+        gt_ctx()->counters.write_calls++;
+        gt_ctx()->counters.bytes_written += (uint64_t)n;
+
+        if (out->mark_input_ns) {
+            if ((size_t)n < out->mark_left) {
+                out->mark_left -= (size_t)n;
+            } else {
+                gt_stats_input_latency(gt_now_ns() - out->mark_input_ns);
+                out->mark_input_ns = 0;
+            }
+        }
+    }
+    output_set_nonblocking(out, false);
+
+    if (out->off == out->len) out->len = out->off = 0;
+    return (int)(out->len - out->off);
+}
@@ -0,0 +1,359 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Frame recording. Every frame sent to the terminal is stored as the
+ * cells it left on screen: a keyframe with the whole grid every
+ * GT_RECORD_KEYFRAME_INTERVAL frames, after a resize and after data was
+ * dropped, otherwise the changed span of each changed row, or for a row
+ * that only moved, the row of the previous frame it came from. Key events
+ * are stored as they are read, so the file shows what each frame
+ * answered.
+ *
+ * Records are serialized on the UI thread and handed to a writer thread
+ * that appends them to the file. When the writer falls more than
+ * GT_RECORD_BACKLOG_MAX bytes behind, records are dropped rather than
+ * waited for; a gap record and a keyframe follow.
+ */
+
+#define GT_RECORD_KEYFRAME_INTERVAL 120
+#define GT_RECORD_BACKLOG_MAX (16u << 20)
+
+struct gt_chunk {
+    struct gt_chunk *next;
+    size_t len;
+    unsigned char data[];
+};
+
+struct gt_recorder {
+    int fd;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    struct gt_chunk *head, *tail;
+    size_t backlog;             // bytes queued for the writer
+    bool stop;
+
+    // Owned by the UI thread
+    unsigned char *buf;         // records not yet queued
+    size_t len, cap;
+    gt_cell_t *prev;            // grid of the last recorded frame
+    uint64_t *prev_hash;        // and its row hashes
+    uint8_t *changed;           // rows of the frame being recorded that changed
+    int width, height;
+    uint64_t last_ns;
+    int since_keyframe;
+    bool need_keyframe;
+    bool gap;
+    bool truncated;             // a record being built lost bytes
+};
+
+// A record that cannot be stored whole is dropped with the rest of its
+// batch by queue_records(), never left half in the stream
+static void put_bytes(struct gt_recorder *rec, const void *data, size_t len) {
+    if (rec->truncated) return;
+    if (rec->len + len > rec->cap) {
+        size_t cap = rec->cap ? rec->cap * 2 : 4096;
+        while (cap < rec->len + len) cap *= 2;
+        unsigned char *buf = gt_realloc(rec->buf, cap);
+        if (!buf) {
+            rec->truncated = true;
+            rec->len = 0;
+            return;
+        }
+        rec->buf = buf;
+        rec->cap = cap;
+    }
+    memcpy(rec->buf + rec->len, data, len);
+    rec->len += len;
+}
+
+static void put_varint(struct gt_recorder *rec, uint64_t value) {
+    unsigned char out[10];
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (unsigned char)value;
+    put_bytes(rec, out, n);
+}
+
+// Cells as style runs: count, fg, bg, attr, then the characters
+static void put_cells(struct gt_recorder *rec, const gt_cell_t *cells, size_t count) {
+    size_t i = 0;
+    while (i < count) {
+        size_t run = 1;
+        while (i + run < count && cells[i + run].fg == cells[i].fg &&
+               cells[i + run].bg == cells[i].bg && cells[i + run].attr == cells[i].attr) run++;
+
+        unsigned char style[3] = { cells[i].fg, cells[i].bg, cells[i].attr };
+        put_varint(rec, run);
+        put_bytes(rec, style, sizeof(style));
+        for (size_t k = i; k < i + run; k++) put_bytes(rec, &cells[k].ch, 1);
+        i += run;
+    }
+}
+
+static void put_header(struct gt_recorder *rec, int type) {
+    uint64_t now = gt_now_ns();
+    unsigned char byte = (unsigned char)type;
+    put_bytes(rec, &byte, 1);
+    put_varint(rec, (now - rec->last_ns) / 1000);
+    rec->last_ns = now;
+}
+
+// Hand the serialized records to the writer, or drop them if it is
+// too far behind
+static void drop_records(struct gt_recorder *rec) {
+    rec->gap = true;
+    rec->need_keyframe = true;
+    rec->truncated = false;
+    rec->len = 0;
+}
+
+static void queue_records(struct gt_recorder *rec) {
+    if (rec->truncated) {
+        drop_records(rec);
+        return;
+    }
+    if (rec->len == 0) return;
+
+    struct gt_chunk *chunk = gt_malloc(sizeof(struct gt_chunk) + rec->len);
+    pthread_mutex_lock(&rec->lock);
+    if (!chunk || rec->backlog + rec->len > GT_RECORD_BACKLOG_MAX) {
+        pthread_mutex_unlock(&rec->lock);
+        free(chunk);
+        drop_records(rec);
+        return;
+    }
+
+    chunk->next = NULL;
+    chunk->len = rec->len;
+    memcpy(chunk->data, rec->buf, rec->len);
+    if (rec->tail) {
+        rec->tail->next = chunk;
+    } else {
+        rec->head = chunk;
+    }
+    rec->tail = chunk;
+    rec->backlog += chunk->len;
+    pthread_cond_signal(&rec->ready);
+    pthread_mutex_unlock(&rec->lock);
+    rec->len = 0;
+}
+
+static void *writer_main(void *arg) {
+    struct gt_recorder *rec = arg;
+    bool failed = false;
+
+    pthread_mutex_lock(&rec->lock);
+    for (;;) {
+        while (!rec->head && !rec->stop) pthread_cond_wait(&rec->ready, &rec->lock);
+        struct gt_chunk *chunk = rec->head;
+        if (!chunk) break;
+        rec->head = chunk->next;
+        if (!rec->head) rec->tail = NULL;
+        pthread_mutex_unlock(&rec->lock);
+
+        // After a write error the rest is discarded
+        size_t off = 0;
+        while (!failed && off < chunk->len) {
+            ssize_t n = write(rec->fd, chunk->data + off, chunk->len - off);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) failed = true;
+            else off += (size_t)n;
+        }
+
+        pthread_mutex_lock(&rec->lock);
+        rec->backlog -= chunk->len;
+        free(chunk);
+    }
+    pthread_mutex_unlock(&rec->lock);
+    return NULL;
+}
+
+static void record_keyframe(struct gt_recorder *rec, const gt_cell_t *cells, const uint64_t *row_hash,
+                            int width, int height) {
+    size_t count = (size_t)width * (size_t)height;
+    if (width != rec->width || height != rec->height) {
+        gt_cell_t *prev = gt_realloc(rec->prev, count * sizeof(gt_cell_t));
+        if (prev) rec->prev = prev;
+        uint64_t *prev_hash = gt_realloc(rec->prev_hash, (size_t)height * sizeof(uint64_t));
+        if (prev_hash) rec->prev_hash = prev_hash;
+        uint8_t *changed = gt_realloc(rec->changed, (size_t)height);
+        if (changed) rec->changed = changed;
+        if (!prev || !prev_hash || !changed) {
+            rec->width = rec->height = 0;
+            return;
+        }
+        rec->width = width;
+        rec->height = height;
+    }
+
+    put_header(rec, GT_RECORD_KEYFRAME);
+    put_varint(rec, (uint64_t)width);
+    put_varint(rec, (uint64_t)height);
+    put_cells(rec, cells, count);
+
+    memcpy(rec->prev, cells, count * sizeof(gt_cell_t));
+    memcpy(rec->prev_hash, row_hash, (size_t)height * sizeof(uint64_t));
+    rec->since_keyframe = 0;
+    rec->need_keyframe = false;
+}
+
+// Row of the previous frame that holds exactly `row`, -1 if none
+static int find_moved_row(const struct gt_recorder *rec, const gt_cell_t *row, uint64_t hash) {
+    size_t width = (size_t)rec->width;
+    for (int y = 0; y < rec->height; y++) {
+        if (rec->prev_hash[y] == hash &&
+            gt_cells_mismatch(row, &rec->prev[(size_t)y * width], width) == width) return y;
+    }
+    return -1;
+}
+
+// A row that scrolled is stored as the row it came from, any other
+// changed row as its changed span
+static void record_delta(struct gt_recorder *rec, const gt_cell_t *cells, const uint64_t *row_hash) {
+    size_t width = (size_t)rec->width;
+
+    put_header(rec, GT_RECORD_DELTA);
+    for (int y = 0; y < rec->height; y++) {
+        const gt_cell_t *row = &cells[(size_t)y * width];
+        const gt_cell_t *prev = &rec->prev[(size_t)y * width];
+        size_t x0 = gt_cells_mismatch(row, prev, width);
+        rec->changed[y] = x0 < width;
+        if (x0 == width) continue;
+
+        put_varint(rec, (uint64_t)y + 1);
+        int from = find_moved_row(rec, row, row_hash[y]);
+        if (from >= 0) {
+            put_varint(rec, 0);
+            put_varint(rec, (uint64_t)from);
+            continue;
+        }
+
+        size_t x1 = width;
+        while (x1 > x0 + 1 && memcmp(&row[x1 - 1], &prev[x1 - 1], sizeof(gt_cell_t)) == 0) x1--;
+        put_varint(rec, x0 + 1);
+        put_varint(rec, x1 - x0);
+        put_cells(rec, &row[x0], x1 - x0);
+    }
+    put_varint(rec, 0);
+
+    // Moved rows were looked up in the old frame, so update it last
+    for (int y = 0; y < rec->height; y++) {
+        if (!rec->changed[y]) continue;
+        memcpy(&rec->prev[(size_t)y * width], &cells[(size_t)y * width], width * sizeof(gt_cell_t));
+        rec->prev_hash[y] = row_hash[y];
+    }
+    rec->since_keyframe++;
+}
+
+// Called with what the terminal shows after each frame
+void gt_record_frame(const gt_cell_t *cells, const uint64_t *row_hash, int width, int height) {
+    struct gt_recorder *rec = gt_ctx()->recorder;
+    if (!rec) return;
+
+    if (rec->gap) {
+        put_header(rec, GT_RECORD_GAP);
+        rec->gap = false;
+    }
+    if (rec->need_keyframe || width != rec->width || height != rec->height ||
+        rec->since_keyframe >= GT_RECORD_KEYFRAME_INTERVAL) {
+        record_keyframe(rec, cells, row_hash, width, height);
+    } else {
+        record_delta(rec, cells, row_hash);
+    }
+    queue_records(rec);
+}
+
+void gt_record_event(const gt_event_t *event) {
+    struct gt_recorder *rec = gt_ctx()->recorder;
+    if (!rec) return;
+
+    put_header(rec, GT_RECORD_EVENT);
+    put_varint(rec, (uint64_t)event->type);
+    put_varint(rec, event->type == GT_EVENT_KEY_PRESS ? (uint64_t)event->data.key : 0);
+    queue_records(rec);
+}
+
+int gt_start_recording(const char *path) {
+    gt_context_t *ctx = gt_ctx();
+    if (!path || ctx->recorder) return -1;
+
+    struct gt_recorder *rec = gt_malloc(sizeof(struct gt_recorder));
+    if (!rec) return -1;
+    memset(rec, 0, sizeof(*rec));
+
+    rec->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (rec->fd < 0) {
+        free(rec);
+        return -1;
+    }
+    pthread_mutex_init(&rec->lock, NULL);
+    pthread_cond_init(&rec->ready, NULL);
+    rec->last_ns = gt_now_ns();
+    rec->need_keyframe = true;
+
+    if (pthread_create(&rec->writer, NULL, writer_main, rec) != 0) {
+        pthread_cond_destroy(&rec->ready);
+        pthread_mutex_destroy(&rec->lock);
+        close(rec->fd);
+        free(rec);
+        return -1;
+    }
+    ctx->recorder = rec;
+
+    put_bytes(rec, GT_RECORD_MAGIC, sizeof(GT_RECORD_MAGIC) - 1);
+    if (ctx->screen.front) {
+        gt_record_frame(ctx->screen.front, ctx->screen.front_hash, ctx->screen.width, ctx->screen.height);
+    }
+    queue_records(rec);
+    return 0;
+}
+
+// Waits for the writer to store everything queued so far
+void gt_stop_recording(void) {
+    gt_context_t *ctx = gt_ctx();
+    struct gt_recorder *rec = ctx->recorder;
+    if (!rec) return;
+    ctx->recorder = NULL;
+
+    pthread_mutex_lock(&rec->lock);
+    rec->stop = true;
+    pthread_cond_signal(&rec->ready);
+    pthread_mutex_unlock(&rec->lock);
+    pthread_join(rec->writer, NULL);
+
+    pthread_cond_destroy(&rec->ready);
+    pthread_mutex_destroy(&rec->lock);
+    close(rec->fd);
+    free(rec->buf);
+    free(rec->prev);
+    free(rec->prev_hash);
+    free(rec->changed);
+    free(rec);
+}
@@ -0,0 +1,822 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Screen model. Drawing only updates the back buffer; gt_screen_flush()
+ * diffs it against the front buffer (what the terminal shows) and queues
+ * escape sequences for the cells that changed. While the previous frame
+ * is still being written the flush is deferred, so intermediate frames
+ * are dropped and only the latest state is ever sent.
+ *
+ * Each frame is wrapped in synchronized-update markers (DEC mode 2026)
+ * when the terminal supports them, so it is presented atomically.
+ * Otherwise the cursor is hidden while the frame is drawn; the whole
+ * frame is queued before the first write() either way.
+ *
+ * Runs of identical cells are encoded as one cell plus REP when the
+ * terminal repeats characters, and runs of plain blanks are erased with
+ * ECH, or EL when they reach the end of the row; blank rows at the
+ * bottom of the screen are erased with a single ED. Erasing relies on the
+ * terminal filling with the current background (bce), as xterm-like
+ * terminals do.
+ *
+ * The latency overlay is drawn into the back buffer only for the
+ * duration of the encode, so it never overwrites what widgets drew.
+ *
+ * Content that moved up or down, as when a list or log scrolls, is found
+ * by matching row hashes of the back buffer against those of the front
+ * buffer at every shift. The longest run is moved on the terminal with
+ * a delete or insert line inside a scroll region (DECSTBM), so only the
+ * rows it brings in are sent.
+ *
+ * Rows nothing was drawn into since the last frame are skipped without
+ * reading them. The others are hashed and compared with the SIMD cell
+ * kernels, which also skip the unchanged stretches within a row.
+ *
+ * With gt_set_render_threads() the rows above the bottom blank block are
+ * split into bands that are diffed and encoded on the render workers,
+ * each into its own buffer. A band starts with the cursor and pen
+ * unknown, so its first change sends an absolute move and a style, and
+ * the buffers are simply queued in row order.
+ */
+
+// Cells never seen by the terminal, they always compare unequal
+#define GT_CELL_UNKNOWN 0
+
+// Rewrite up to this many unchanged cells rather than moving the cursor
+#define GT_SKIP_REWRITE_MAX 4
+
+// Shortest run worth a REP or ECH sequence
+#define GT_RUN_MIN 8
+
+#define GT_OVERLAY_MAX 64
+
+#define GT_RENDER_THREADS_MAX 64
+
+// Bands per render thread, so threads that finish early take more of them
+#define GT_BANDS_PER_THREAD 4
+
+// Fewest rows a scroll has to save from being repainted
+#define GT_SCROLL_MIN_ROWS 3
+
+// Fewer rows per band cost more in cursor moves than they save
+#define GT_BAND_MIN_ROWS 8
+
+// Escape sequences for a part of the screen
+struct gt_encoder {
+    char *buf;
+    size_t len, cap;
+    gt_cell_t pen;
+    bool pen_known;
+    int cur_x, cur_y;
+    uint64_t cells_changed;
+    bool failed;                // bytes were lost, buf is not the whole change
+};
+
+static const gt_cell_t blank_cell = { ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+
+// Cells have no padding, so this is a single 32-bit compare
+static bool cell_equal(const gt_cell_t *a, const gt_cell_t *b) {
+    return memcmp(a, b, sizeof(gt_cell_t)) == 0;
+}
+
+static bool style_equal(const gt_cell_t *a, const gt_cell_t *b) {
+    return a->fg == b->fg && a->bg == b->bg && a->attr == b->attr;
+}
+
+// Erased cells look exactly like this one
+static bool cell_erasable(const gt_cell_t *cell) {
+    return cell->ch == ' ' && cell->attr == GT_ATTR_NORMAL;
+}
+
+// The terminal has just been cleared, so both buffers start out blank
+int gt_screen_resize(int width, int height) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    size_t count = (size_t)width * (size_t)height;
+    gt_cell_t *new_back = gt_malloc(count * sizeof(gt_cell_t));
+    gt_cell_t *new_front = gt_malloc(count * sizeof(gt_cell_t));
+    uint64_t *new_hash = gt_malloc(2 * (size_t)height * sizeof(uint64_t));
+    uint8_t *new_dirty = gt_malloc((size_t)height);
+    if (!new_back || !new_front || !new_hash || !new_dirty) {
+        free(new_back);
+        free(new_front);
+        free(new_hash);
+        free(new_dirty);
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        new_back[i] = blank_cell;
+        new_front[i] = blank_cell;
+    }
+    uint64_t blank_hash = gt_cells_hash(new_front, (size_t)width);
+    for (int y = 0; y < height; y++) new_hash[y] = blank_hash;
+    memset(new_dirty, 0, (size_t)height);
+
+    free(scr->back);
+    free(scr->front);
+    free(scr->front_hash);
+    free(scr->row_dirty);
+    scr->back = new_back;
+    scr->front = new_front;
+    scr->front_hash = new_hash;
+    scr->back_hash = new_hash + height;     // same allocation
+    scr->blank_hash = blank_hash;
+    scr->row_dirty = new_dirty;
+    scr->width = width;
+    scr->height = height;
+    scr->flush_pending = false;
+    return 0;
+}
+
+void gt_screen_free(void) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    free(scr->back);
+    free(scr->front);
+    free(scr->front_hash);
+    free(scr->row_dirty);
+    scr->back = scr->front = NULL;
+    scr->front_hash = scr->back_hash = NULL;
+    scr->row_dirty = NULL;
+    scr->width = scr->height = 0;
+    scr->flush_pending = false;
+    scr->cursor_x = scr->cursor_y = -1;
+
+    gt_workers_destroy(scr->workers);
+    scr->workers = NULL;
+    for (int i = 0; i < scr->encoder_count; i++) free(scr->encoders[i].buf);
+    free(scr->encoders);
+    scr->encoders = NULL;
+    scr->encoder_count = 0;
+}
+
+int gt_screen_width(void) {
+    return gt_ctx()->screen.width;
+}
+
+int gt_screen_height(void) {
+    return gt_ctx()->screen.height;
+}
+
+void gt_screen_put(int x, int y, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    if (x < 0 || x >= scr->width || y < 0 || y >= scr->height) return;
+
+    gt_cell_t *cell = &scr->back[(size_t)y * (size_t)scr->width + (size_t)x];
+    scr->row_dirty[y] = 1;
+    cell->ch = ch;
+    cell->fg = (uint8_t)fg;
+    cell->bg = (uint8_t)bg;
+    cell->attr = (uint8_t)attr;
+}
+
+// Copy a rectangle of cells; rows are contiguous, so each one is a memcpy
+void gt_screen_blit(int x, int y, int width, int height, const gt_cell_t *cells, size_t stride) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    if (x < 0) { cells += -x; width += x; x = 0; }
+    if (y < 0) { cells += (size_t)-y * stride; height += y; y = 0; }
+    if (x + width > scr->width) width = scr->width - x;
+    if (y + height > scr->height) height = scr->height - y;
+    if (width <= 0 || height <= 0) return;
+
+    memset(&scr->row_dirty[y], 1, (size_t)height);
+    for (int row = 0; row < height; row++) {
+        memcpy(&scr->back[(size_t)(y + row) * (size_t)scr->width + (size_t)x],
+               &cells[(size_t)row * stride], (size_t)width * sizeof(gt_cell_t));
+    }
+}
+
+void gt_screen_fill(int x, int y, int width, int height, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    if (x < 0) { width += x; x = 0; }
+    if (y < 0) { height += y; y = 0; }
+    if (x + width > scr->width) width = scr->width - x;
+    if (y + height > scr->height) height = scr->height - y;
+    if (width <= 0 || height <= 0) return;
+
+    gt_cell_t cell = { ch, (uint8_t)fg, (uint8_t)bg, (uint8_t)attr };
+    memset(&scr->row_dirty[y], 1, (size_t)height);
+    for (int row = y; row < y + height; row++) {
+        gt_cell_t *dst = &scr->back[(size_t)row * (size_t)scr->width + (size_t)x];
+        for (int i = 0; i < width; i++) dst[i] = cell;
+    }
+}
+
+// Forget what the terminal shows, the next flush repaints everything
+void gt_screen_invalidate(void) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    if (!scr->front) return;
+
+    size_t count = (size_t)scr->width * (size_t)scr->height;
+    for (size_t i = 0; i < count; i++) scr->front[i].ch = GT_CELL_UNKNOWN;
+
+    for (int y = 0; y < scr->height; y++) {
+        scr->front_hash[y] = gt_cells_hash(&scr->front[(size_t)y * (size_t)scr->width], (size_t)scr->width);
+    }
+    memset(scr->row_dirty, 1, (size_t)scr->height);
+}
+
+void gt_screen_set_cursor(int x, int y) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    scr->cursor_x = x;
+    scr->cursor_y = y;
+}
+
+void gt_screen_set_cursor_visible(bool visible) {
+    gt_ctx()->screen.cursor_visible = visible;
+}
+
+void gt_screen_set_sync_update(bool enabled) {
+    gt_ctx()->screen.sync_update = enabled;
+}
+
+void gt_screen_set_repeat(bool enabled) {
+    gt_ctx()->screen.repeat = enabled;
+}
+
+// The workers are started by the next frame that needs them
+void gt_set_render_threads(int threads) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    if (threads < 1) threads = 1;
+    if (threads > GT_RENDER_THREADS_MAX) threads = GT_RENDER_THREADS_MAX;
+    if (threads == scr->render_threads) return;
+
+    gt_workers_destroy(scr->workers);
+    scr->workers = NULL;
+    scr->render_threads = threads;
+}
+
+static void enc_write(struct gt_encoder *enc, const void *data, size_t len) {
+    if (enc->len + len > enc->cap) {
+        // Plain realloc: bands are encoded on worker threads, and
+        // gt_realloc() counts into the calling thread's context
+        size_t cap = enc->cap ? enc->cap * 2 : 1024;
+        while (cap < enc->len + len) cap *= 2;
+        char *buf = realloc(enc->buf, cap);
+        if (!buf) {
+            enc->failed = true;
+            return;
+        }
+        enc->buf = buf;
+        enc->cap = cap;
+    }
+    memcpy(enc->buf + enc->len, data, len);
+    enc->len += len;
+}
+
+static void enc_puts(struct gt_encoder *enc, const char *str) {
+    enc_write(enc, str, strlen(str));
+}
+
+static void emit_move(struct gt_encoder *enc, int x, int y) {
+    char seq[32];
+    int len = snprintf(seq, sizeof(seq), "\033[%d;%dH", y + 1, x + 1);
+    enc_write(enc, seq, (size_t)len);
+}
+
+static void emit_count(struct gt_encoder *enc, const char *fmt, int count) {
+    char seq[16];
+    int len = snprintf(seq, sizeof(seq), fmt, count);
+    enc_write(enc, seq, (size_t)len);
+}
+
+// The sequence comes from the style table, built once per style
+static void emit_style(struct gt_encoder *enc, const gt_cell_t *cell) {
+    const struct gt_style *style = gt_style_get(gt_style_intern(cell->fg, cell->bg, cell->attr));
+    enc_write(enc, style->sgr, style->sgr_len);
+}
+
+static void set_pen(struct gt_encoder *enc, const gt_cell_t *cell) {
+    if (enc->pen_known && style_equal(cell, &enc->pen)) return;
+    emit_style(enc, cell);
+    enc->pen = *cell;
+    enc->pen_known = true;
+}
+
+// Every encoder starts with the cursor and pen unknown, so the first
+// change it sends positions the cursor and sets the style itself
+static void encoder_reset(struct gt_encoder *enc) {
+    enc->len = 0;
+    enc->pen = blank_cell;
+    enc->pen_known = false;
+    enc->cur_x = enc->cur_y = -1;
+    enc->cells_changed = 0;
+    enc->failed = false;
+}
+
+// Hash the rows drawn into since they were encoded; the others are not
+// read at all, they still match the terminal. Returns how many rows
+// changed by hash
+static int hash_rows(struct gt_screen *scr) {
+    int changed = 0;
+    for (int y = 0; y < scr->height; y++) {
+        if (scr->row_dirty[y]) {
+            scr->back_hash[y] = gt_cells_hash(&scr->back[(size_t)y * (size_t)scr->width], (size_t)scr->width);
+        } else {
+            scr->back_hash[y] = scr->front_hash[y];
+        }
+        changed += scr->back_hash[y] != scr->front_hash[y];
+    }
+    return changed;
+}
+
+// Whether back row `y` matches front row `y + shift`
+static bool row_matches(const struct gt_screen *scr, int y, int shift) {
+    const gt_cell_t *back = &scr->back[(size_t)y * (size_t)scr->width];
+    const gt_cell_t *front = &scr->front[(size_t)(y + shift) * (size_t)scr->width];
+    return scr->back_hash[y] == scr->front_hash[y + shift] &&
+           gt_cells_mismatch(back, front, (size_t)scr->width) == (size_t)scr->width;
+}
+
+// Whether row y differs from what the terminal shows. A hash mismatch
+// proves a change without comparing the cells
+static bool row_changed(const struct gt_screen *scr, int y) {
+    return scr->row_dirty[y] && !row_matches(scr, y, 0);
+}
+
+// First row of the blank block at the bottom of the back buffer
+static int blank_rows_start(const struct gt_screen *scr) {
+    const gt_cell_t *fill = &scr->back[(size_t)(scr->height - 1) * (size_t)scr->width];
+    if (!cell_erasable(fill)) return scr->height;
+
+    int y = scr->height;
+    while (y > 0) {
+        const gt_cell_t *row = &scr->back[(size_t)(y - 1) * (size_t)scr->width];
+        int x = 0;
+        while (x < scr->width && cell_equal(&row[x], fill)) x++;
+        if (x < scr->width) break;
+        y--;
+    }
+    return y;
+}
+
+// Find the run of rows that the terminal already shows `shift` rows
+// further down (up for a negative shift) and that saves the most rows
+// from being repainted. Returns the rows saved
+static int find_scroll(const struct gt_screen *scr, int *start, int *len, int *shift) {
+    int best = 0;
+
+    for (int d = 1 - scr->height; d < scr->height; d++) {
+        if (d == 0) continue;
+        int y0 = d < 0 ? -d : 0;
+        int y1 = d > 0 ? scr->height - d : scr->height;
+        int run = 0, saved = 0;
+
+        for (int y = y0; y <= y1; y++) {
+            if (y < y1 && scr->back_hash[y] == scr->front_hash[y + d]) {
+                run++;
+                // Blank rows are cheap to repaint anyway
+                saved += scr->back_hash[y] != scr->front_hash[y] && scr->back_hash[y] != scr->blank_hash;
+                continue;
+            }
+            if (saved > best) {
+                best = saved;
+                *start = y - run;
+                *len = run;
+                *shift = d;
+            }
+            run = saved = 0;
+        }
+    }
+    return best;
+}
+
+// Move rows that only changed position with a delete or insert line in
+// a scroll region, the rows it brings in are left to the row encoder
+static void encode_scroll(struct gt_screen *scr, struct gt_encoder *enc) {
+    int start = 0, len = 0, shift = 0;
+    if (find_scroll(scr, &start, &len, &shift) < GT_SCROLL_MIN_ROWS) return;
+
+    // Rule out hash collisions before touching the terminal
+    for (int y = start; y < start + len; y++) {
+        if (!row_matches(scr, y, shift)) return;
+    }
+
+    int count = shift > 0 ? shift : -shift;
+    int top = shift > 0 ? start : start + shift;
+    int bottom = start + len - 1 + (shift > 0 ? shift : 0);
+    bool region = top > 0 || bottom < scr->height - 1;
+
+    // Inserted lines take the current background, keep it the default
+    set_pen(enc, &blank_cell);
+    if (region) {
+        char seq[32];
+        int n = snprintf(seq, sizeof(seq), "\033[%d;%dr", top + 1, bottom + 1);
+        enc_write(enc, seq, (size_t)n);
+    }
+    emit_move(enc, 0, top);
+    emit_count(enc, shift > 0 ? "\033[%dM" : "\033[%dL", count);
+
+    // Resetting the region homes the cursor
+    if (region) enc_puts(enc, "\033[r");
+    enc->cur_x = 0;
+    enc->cur_y = region ? 0 : top;
+
+    // Shift the front rows the same way
+    size_t width = (size_t)scr->width;
+    size_t moved = (size_t)(bottom - top + 1 - count);
+    int from = shift > 0 ? top + count : top;
+    int to = shift > 0 ? top : top + count;
+    int blank = shift > 0 ? bottom - count + 1 : top;
+    memmove(&scr->front[(size_t)to * width], &scr->front[(size_t)from * width], moved * width * sizeof(gt_cell_t));
+    memmove(&scr->front_hash[to], &scr->front_hash[from], moved * sizeof(uint64_t));
+
+    for (int y = blank; y < blank + count; y++) {
+        gt_cell_t *row = &scr->front[(size_t)y * width];
+        for (size_t x = 0; x < width; x++) row[x] = blank_cell;
+        scr->front_hash[y] = scr->blank_hash;
+        scr->row_dirty[y] = 1;
+    }
+}
+
+// Clearing several rows at the bottom is a single ED. Returns the rows
+// still left to encode cell by cell
+static int encode_blank_rows(struct gt_screen *scr, struct gt_encoder *enc) {
+    int blank = blank_rows_start(scr);
+    int changed = 0;
+    for (int y = blank; y < scr->height && changed < 2; y++) changed += row_changed(scr, y);
+    if (changed < 2) return scr->height;
+
+    const gt_cell_t *fill = &scr->back[(size_t)blank * (size_t)scr->width];
+    emit_move(enc, 0, blank);
+    set_pen(enc, fill);
+    enc_puts(enc, "\033[J");
+    enc->cur_x = 0;
+    enc->cur_y = blank;
+
+    gt_cell_t *front = &scr->front[(size_t)blank * (size_t)scr->width];
+    size_t count = (size_t)(scr->height - blank) * (size_t)scr->width;
+    for (size_t i = 0; i < count; i++) {
+        if (!cell_equal(&front[i], fill)) enc->cells_changed++;
+        front[i] = *fill;
+    }
+
+    for (int y = blank; y < scr->height; y++) {
+        scr->front_hash[y] = scr->back_hash[y];
+        scr->row_dirty[y] = 0;
+    }
+    return blank;
+}
+
+// Queue the changes of rows [y0, y1), front becomes back there. Only
+// touches the rows given and the encoder, so bands can run in parallel
+static void encode_rows(struct gt_screen *scr, struct gt_encoder *enc, int y0, int y1) {
+    // Find the rows that changed first, so the trace tells the diff
+    // apart from the escape sequences; row_dirty keeps the answer
+    GT_TRACE_BEGIN(diff_start);
+    for (int y = y0; y < y1; y++) scr->row_dirty[y] = row_changed(scr, y);
+    GT_TRACE_END(diff_start, "diff");
+
+    for (int y = y0; y < y1; y++) {
+        if (!scr->row_dirty[y]) continue;
+        scr->row_dirty[y] = 0;
+        scr->front_hash[y] = scr->back_hash[y];
+
+        gt_cell_t *brow = &scr->back[(size_t)y * (size_t)scr->width];
+        gt_cell_t *frow = &scr->front[(size_t)y * (size_t)scr->width];
+
+        for (int x = 0; ; x++) {
+            x += (int)gt_cells_mismatch(&brow[x], &frow[x], (size_t)(scr->width - x));
+            if (x >= scr->width) break;
+
+            if (enc->cur_y == y && enc->cur_x < x && x - enc->cur_x <= GT_SKIP_REWRITE_MAX) {
+                // Short gaps in the same style are cheaper to rewrite
+                int gap = enc->cur_x;
+                while (gap < x && style_equal(&brow[gap], &enc->pen)) gap++;
+                if (gap == x) {
+                    for (int i = enc->cur_x; i < x; i++) enc_write(enc, &brow[i].ch, 1);
+                    enc->cur_x = x;
+                }
+            }
+            if (enc->cur_y != y || enc->cur_x != x) emit_move(enc, x, y);
+            set_pen(enc, &brow[x]);
+            enc->cur_y = y;
+
+            int run = 1;
+            while (x + run < scr->width && cell_equal(&brow[x + run], &brow[x])) run++;
+
+            if (x + run == scr->width && run > 3 && cell_erasable(&brow[x])) {
+                // Blank to the end of the row
+                enc_puts(enc, "\033[K");
+                enc->cur_x = x;
+            } else {
+                // Unchanged cells at the end of the run need not be sent
+                while (run > 1 && cell_equal(&brow[x + run - 1], &frow[x + run - 1])) run--;
+
+                if (run >= GT_RUN_MIN && cell_erasable(&brow[x])) {
+                    emit_count(enc, "\033[%dX", run);
+                    enc->cur_x = x;
+                } else if (run >= GT_RUN_MIN && scr->repeat) {
+                    enc_write(enc, &brow[x].ch, 1);
+                    emit_count(enc, "\033[%db", run - 1);
+                    enc->cur_x = x + run;
+                } else {
+                    run = 1;
+                    enc_write(enc, &brow[x].ch, 1);
+                    enc->cur_x = x + 1;
+                }
+            }
+
+            for (int i = x; i < x + run; i++) {
+                if (!cell_equal(&frow[i], &brow[i])) enc->cells_changed++;
+                frow[i] = brow[i];
+            }
+            x += run - 1;
+        }
+    }
+}
+
+struct band_job {
+    struct gt_screen *scr;
+    int rows;                   // rows [0, rows) are split into bands
+    int bands;
+};
+
+// Runs on the render workers
+static void encode_band(void *arg, int index) {
+    struct band_job *job = arg;
+    GT_TRACE_BEGIN(start);
+    int y0 = (int)((long)job->rows * index / job->bands);
+    int y1 = (int)((long)job->rows * (index + 1) / job->bands);
+    encode_rows(job->scr, &job->scr->encoders[1 + index], y0, y1);
+    GT_TRACE_END(start, "band");
+}
+
+// One band, or several bands on the render workers for large screens
+static int band_count(struct gt_screen *scr, int rows) {
+    if (scr->render_threads <= 1) return 1;
+
+    if (!scr->workers) {
+        scr->workers = gt_workers_create(scr->render_threads - 1);
+        if (!scr->workers) return 1;
+    }
+
+    int bands = scr->render_threads * GT_BANDS_PER_THREAD;
+    if (bands > rows / GT_BAND_MIN_ROWS) bands = rows / GT_BAND_MIN_ROWS;
+    return bands > 1 ? bands : 1;
+}
+
+static bool reserve_encoders(struct gt_screen *scr, int count) {
+    if (count <= scr->encoder_count) return true;
+
+    struct gt_encoder *encoders = gt_realloc(scr->encoders, (size_t)count * sizeof(struct gt_encoder));
+    if (!encoders) return false;
+    memset(&encoders[scr->encoder_count], 0, (size_t)(count - scr->encoder_count) * sizeof(struct gt_encoder));
+    scr->encoders = encoders;
+    scr->encoder_count = count;
+    return true;
+}
+
+// Encode every changed row into the encoders, front becomes back.
+// Returns the number of encoders used
+static int encode_cells(struct gt_screen *scr) {
+    if (!reserve_encoders(scr, 1)) return 0;
+    encoder_reset(&scr->encoders[0]);
+    if (hash_rows(scr) >= GT_SCROLL_MIN_ROWS) encode_scroll(scr, &scr->encoders[0]);
+    int rows = encode_blank_rows(scr, &scr->encoders[0]);
+
+    // A single band carries on where the blank rows left the cursor
+    int bands = band_count(scr, rows);
+    if (bands == 1 || !reserve_encoders(scr, 1 + bands)) {
+        encode_rows(scr, &scr->encoders[0], 0, rows);
+        return 1;
+    }
+
+    for (int i = 1; i <= bands; i++) encoder_reset(&scr->encoders[i]);
+    struct band_job job = { scr, rows, bands };
+    gt_workers_run(scr->workers, bands, encode_band, &job);
+    return 1 + bands;
+}
+
+// Draw the overlay in the top right corner, saving the cells under it
+static int overlay_draw(gt_cell_t *saved) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    char text[GT_OVERLAY_MAX + 1];
+    int len = (int)gt_stats_overlay_text(text, sizeof(text));
+    if (len > scr->width) len = scr->width;
+
+    gt_cell_t *row = &scr->back[scr->width - len];
+    if (len > 0) scr->row_dirty[0] = 1;
+    for (int i = 0; i < len; i++) {
+        saved[i] = row[i];
+        row[i].ch = text[i];
+        row[i].fg = GT_COLOR_BLACK;
+        row[i].bg = GT_COLOR_YELLOW;
+        row[i].attr = GT_ATTR_NORMAL;
+    }
+    return len;
+}
+
+static void overlay_restore(const gt_cell_t *saved, int len) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    memcpy(&scr->back[scr->width - len], saved, (size_t)len * sizeof(gt_cell_t));
+    if (len > 0) scr->row_dirty[0] = 1;
+}
+
+static bool encode_frame(void) {
+    gt_context_t *ctx = gt_ctx();
+    struct gt_screen *scr = &ctx->screen;
+    gt_cell_t saved[GT_OVERLAY_MAX];
+    int overlay_len = overlay_draw(saved);
+
+    GT_TRACE_BEGIN(start);
+    int count = encode_cells(scr);
+    overlay_restore(saved, overlay_len);
+
+    // Nothing changed, do not send an empty frame
+    bool emitted = false, failed = false;
+    for (int i = 0; i < count; i++) {
+        emitted |= scr->encoders[i].len > 0;
+        failed |= scr->encoders[i].failed;
+        ctx->counters.cells_changed += scr->encoders[i].cells_changed;
+    }
+
+    // Front already holds cells whose bytes were lost: send none of the
+    // frame, and repaint everything once there is memory again
+    if (failed) {
+        gt_screen_invalidate();
+        gt_request_frame();
+        GT_TRACE_END(start, "encode");
+        return false;
+    }
+    if (!emitted) {
+        GT_TRACE_END(start, "encode");
+        return false;
+    }
+
+    if (scr->sync_update) {
+        gt_output_puts("\033[?2026h");
+    } else if (scr->cursor_visible) {
+        gt_output_puts("\033[?25l");
+    }
+
+    // Bands are joined in row order; each one positions its own cursor
+    for (int i = 0; i < count; i++) gt_output_write(scr->encoders[i].buf, scr->encoders[i].len);
+
+    gt_output_puts("\033[0m");
+    if (scr->cursor_x >= 0 && scr->cursor_y >= 0) {
+        char seq[32];
+        int len = snprintf(seq, sizeof(seq), "\033[%d;%dH", scr->cursor_y + 1, scr->cursor_x + 1);
+        gt_output_write(seq, (size_t)len);
+    }
+
+    if (scr->sync_update) {
+        gt_output_puts("\033[?2026l");
+    } else if (scr->cursor_visible) {
+        gt_output_puts("\033[?25h");
+    }
+    ctx->counters.frames_rendered++;
+    gt_record_frame(scr->front, scr->front_hash, scr->width, scr->height);
+    gt_share_frame();
+    GT_TRACE_END(start, "encode");
+    return true;
+}
+
+void gt_screen_flush(void) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    if (!scr->back) return;
+
+    // The terminal is still busy with an older frame, send this one later
+    if (gt_output_pending() > 0) {
+        gt_output_drain();
+        if (gt_output_pending() > 0) {
+            scr->flush_pending = true;
+            gt_ctx()->counters.frames_dropped++;
+            return;
+        }
+    }
+
+    scr->flush_pending = false;
+
+    // A key that changed nothing on screen is not measured
+    uint64_t input_ns = gt_stats_take_input();
+    if (encode_frame() && input_ns) gt_output_mark_frame(input_ns);
+    gt_output_drain();
+}
+
+bool gt_screen_flush_pending(void) {
+    return gt_ctx()->screen.flush_pending;
+}
+
+// A copy of what someone other than the terminal shows, such as a viewer
+// attached with gt_start_sharing(). It is brought up to date with the
+// frame the terminal last received by the same encoder
+struct gt_mirror {
+    gt_cell_t *cells;
+    uint64_t *hash;
+    uint8_t *dirty;
+    int width, height;
+    bool clear;                 // the viewer has to be cleared first
+    struct gt_encoder enc;
+};
+
+struct gt_mirror *gt_mirror_create(void) {
+    struct gt_mirror *mirror = gt_malloc(sizeof(struct gt_mirror));
+    if (mirror) memset(mirror, 0, sizeof(*mirror));
+    return mirror;
+}
+
+void gt_mirror_destroy(struct gt_mirror *mirror) {
+    if (!mirror) return;
+    free(mirror->cells);
+    free(mirror->hash);
+    free(mirror->dirty);
+    free(mirror->enc.buf);
+    free(mirror);
+}
+
+static int mirror_resize(struct gt_mirror *mirror, const struct gt_screen *scr) {
+    size_t count = (size_t)scr->width * (size_t)scr->height;
+    gt_cell_t *cells = gt_malloc(count * sizeof(gt_cell_t));
+    uint64_t *hash = gt_malloc((size_t)scr->height * sizeof(uint64_t));
+    uint8_t *dirty = gt_malloc((size_t)scr->height);
+    if (!cells || !hash || !dirty) {
+        free(cells);
+        free(hash);
+        free(dirty);
+        return -1;
+    }
+
+    for (size_t i = 0; i < count; i++) cells[i] = blank_cell;
+    for (int y = 0; y < scr->height; y++) hash[y] = scr->blank_hash;
+
+    free(mirror->cells);
+    free(mirror->hash);
+    free(mirror->dirty);
+    mirror->cells = cells;
+    mirror->hash = hash;
+    mirror->dirty = dirty;
+    mirror->width = scr->width;
+    mirror->height = scr->height;
+    mirror->clear = true;
+    return 0;
+}
+
+// Escape sequences that turn the mirror into what the terminal shows,
+// valid until the next update. The mirror's terminal is not probed, so
+// REP is not used. Returns NULL with *len 0 when nothing changed
+const char *gt_mirror_update(struct gt_mirror *mirror, size_t *len) {
+    struct gt_screen *scr = &gt_ctx()->screen;
+    struct gt_encoder *enc = &mirror->enc;
+    *len = 0;
+    if (!scr->front) return NULL;
+    if ((mirror->width != scr->width || mirror->height != scr->height) && mirror_resize(mirror, scr) != 0) {
+        return NULL;
+    }
+
+    encoder_reset(enc);
+    enc_puts(enc, "\033[?2026h\033[?25l");
+    size_t prefix = enc->len;
+    if (mirror->clear) {
+        enc_puts(enc, "\033[0m\033[2J");
+        mirror->clear = false;
+    }
+
+    // The terminal's buffer stands in for the back buffer
+    struct gt_screen view = *scr;
+    if (view.height <= 0) return NULL;
+    view.back = scr->front;
+    view.back_hash = scr->front_hash;
+    view.front = mirror->cells;
+    view.front_hash = mirror->hash;
+    view.row_dirty = mirror->dirty;
+    view.repeat = false;
+
+    int changed = 0;
+    for (int y = 0; y < view.height; y++) changed += view.back_hash[y] != view.front_hash[y];
+    memset(view.row_dirty, 1, (size_t)view.height);
+    if (changed >= GT_SCROLL_MIN_ROWS) encode_scroll(&view, enc);
+    encode_rows(&view, enc, 0, encode_blank_rows(&view, enc));
+
+    // The mirror took cells whose bytes were lost; clear the viewer and
+    // send it everything with the next update
+    if (enc->failed) {
+        mirror->width = mirror->height = 0;
+        return NULL;
+    }
+    if (enc->len == prefix) return NULL;
+    enc_puts(enc, "\033[0m");
+    if (scr->cursor_x >= 0 && scr->cursor_y >= 0) emit_move(enc, scr->cursor_x, scr->cursor_y);
+    enc_puts(enc, scr->cursor_visible ? "\033[?25h\033[?2026l" : "\033[?2026l");
+    *len = enc->len;
+    return enc->buf;
+}
@@ -0,0 +1,292 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/*
+ * Screen sharing. The screen is served on a Unix socket to any number
+ * of viewers (tools/gtview), which receive the same escape sequences a
+ * terminal would. Every viewer has a mirror of what it was last sent and
+ * at most one update in flight: a new one is encoded from the latest
+ * frame only once the previous one was written completely. A viewer that
+ * reads slowly so gets fewer, larger deltas, and never holds up the
+ * terminal, the other viewers or the application.
+ *
+ * With viewer input enabled, what the oldest attached viewer types is
+ * read as keyboard input; the others only watch. All of it runs in
+ * gt_wait_event() on the UI thread.
+ */
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0          // SO_NOSIGPIPE is set on the socket instead
+#endif
+
+#define GT_SHARE_BACKLOG 8
+
+struct gt_viewer {
+    int fd;
+    struct gt_mirror *mirror;
+    const char *queue;          // update being sent, owned by the mirror
+    size_t len, off;
+    uint64_t frame;             // frame the mirror was last updated to
+    struct gt_viewer *next;
+};
+
+struct gt_share {
+    int listen_fd;
+    char *path;
+    bool viewer_input;
+    uint64_t frame;             // bumped for every frame sent
+    struct gt_viewer *viewers;  // oldest first
+};
+
+static void set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags >= 0) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static void drop_viewer(struct gt_share *share, struct gt_viewer *viewer) {
+    struct gt_viewer **link = &share->viewers;
+    while (*link != viewer) link = &(*link)->next;
+    *link = viewer->next;
+
+    close(viewer->fd);
+    gt_mirror_destroy(viewer->mirror);
+    free(viewer);
+}
+
+// Send what the socket takes, then the next update if the viewer is
+// behind. Returns false once the viewer is gone
+static bool send_viewer(struct gt_share *share, struct gt_viewer *viewer) {
+    for (;;) {
+        while (viewer->off < viewer->len) {
+            ssize_t n = send(viewer->fd, viewer->queue + viewer->off, viewer->len - viewer->off, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            if (n <= 0) return false;
+            viewer->off += (size_t)n;
+        }
+        if (viewer->frame == share->frame) return true;
+
+        viewer->frame = share->frame;
+        viewer->queue = gt_mirror_update(viewer->mirror, &viewer->len);
+        viewer->off = 0;
+    }
+}
+
+static void accept_viewer(struct gt_share *share) {
+    int fd = accept(share->listen_fd, NULL, NULL);
+    if (fd < 0) return;
+
+    // Viewers are waited on with select()
+    if (fd >= FD_SETSIZE) {
+        close(fd);
+        return;
+    }
+    set_nonblocking(fd);
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+    struct gt_viewer *viewer = gt_malloc(sizeof(struct gt_viewer));
+    struct gt_mirror *mirror = gt_mirror_create();
+    if (!viewer || !mirror) {
+        free(viewer);
+        gt_mirror_destroy(mirror);
+        close(fd);
+        return;
+    }
+    viewer->fd = fd;
+    viewer->mirror = mirror;
+    viewer->queue = NULL;
+    viewer->len = viewer->off = 0;
+    viewer->frame = share->frame - 1;   // paint the whole screen first
+    viewer->next = NULL;
+
+    struct gt_viewer **link = &share->viewers;
+    while (*link) link = &(*link)->next;
+    *link = viewer;
+
+    if (!send_viewer(share, viewer)) drop_viewer(share, viewer);
+}
+
+// Called after every frame sent to the terminal
+void gt_share_frame(void) {
+    struct gt_share *share = gt_ctx()->share;
+    if (!share) return;
+
+    share->frame++;
+    struct gt_viewer *viewer = share->viewers;
+    while (viewer) {
+        struct gt_viewer *next = viewer->next;
+        if (viewer->off == viewer->len && !send_viewer(share, viewer)) drop_viewer(share, viewer);
+        viewer = next;
+    }
+}
+
+// Add the sockets to wait for, returns the new highest descriptor
+int gt_share_fds(fd_set *readfds, fd_set *writefds, int max_fd) {
+    gt_context_t *ctx = gt_ctx();
+    struct gt_share *share = ctx->share;
+    if (!share) return max_fd;
+
+    FD_SET(share->listen_fd, readfds);
+    if (share->listen_fd > max_fd) max_fd = share->listen_fd;
+
+    for (struct gt_viewer *viewer = share->viewers; viewer; viewer = viewer->next) {
+        // The controlling viewer's keys wait in the socket while the input buffer is full
+        bool control = share->viewer_input && viewer == share->viewers;
+        if (!control || ctx->input_len < sizeof(ctx->input_buf)) FD_SET(viewer->fd, readfds);
+        if (viewer->off < viewer->len) FD_SET(viewer->fd, writefds);
+        if (viewer->fd > max_fd) max_fd = viewer->fd;
+    }
+    return max_fd;
+}
+
+void gt_share_handle(const fd_set *readfds, const fd_set *writefds) {
+    gt_context_t *ctx = gt_ctx();
+    struct gt_share *share = ctx->share;
+    if (!share) return;
+
+    struct gt_viewer *viewer = share->viewers;
+    while (viewer) {
+        struct gt_viewer *next = viewer->next;
+        bool alive = true;
+
+        if (FD_ISSET(viewer->fd, readfds)) {
+            unsigned char buf[GT_INPUT_BUFFER_SIZE];
+            size_t room = sizeof(buf);
+            bool control = share->viewer_input && viewer == share->viewers;
+            if (control) room = sizeof(ctx->input_buf) - ctx->input_len;
+
+            ssize_t n = read(viewer->fd, buf, room);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+                alive = false;
+            } else if (n > 0 && control) {
+                gt_input_push(buf, (size_t)n);
+            }
+        }
+        if (alive && FD_ISSET(viewer->fd, writefds)) alive = send_viewer(share, viewer);
+        if (!alive) drop_viewer(share, viewer);
+        viewer = next;
+    }
+
+    // After the viewers, so a new one is not looked at before its first select
+    if (FD_ISSET(share->listen_fd, readfds)) accept_viewer(share);
+}
+
+// A socket left behind by a process that is gone refuses connections
+static bool socket_stale(const struct sockaddr_un *addr) {
+    struct stat st;
+    if (lstat(addr->sun_path, &st) != 0 || !S_ISSOCK(st.st_mode)) return false;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    bool stale = connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) != 0 && errno == ECONNREFUSED;
+    close(fd);
+    return stale;
+}
+
+// Only the owner may watch, or type; connecting needs write permission.
+// The socket is created 0600 rather than tightened after bind(), which
+// would leave it open to others in between. The umask is per process,
+// so a file another thread creates meanwhile is affected too
+static int bind_private(int fd, const struct sockaddr_un *addr) {
+    mode_t mask = umask(0177);
+    int ret = bind(fd, (const struct sockaddr *)addr, sizeof(*addr));
+    int saved_errno = errno;
+    umask(mask);
+    errno = saved_errno;
+    return ret;
+}
+
+int gt_start_sharing(const char *socket_path, bool viewer_input) {
+    gt_context_t *ctx = gt_ctx();
+    struct sockaddr_un addr;
+    if (!socket_path || ctx->share || strlen(socket_path) >= sizeof(addr.sun_path)) return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (fd >= FD_SETSIZE) {
+        close(fd);
+        return -1;
+    }
+    int ret = bind_private(fd, &addr);
+    if (ret != 0 && errno == EADDRINUSE && socket_stale(&addr)) {
+        unlink(socket_path);
+        ret = bind_private(fd, &addr);
+    }
+    if (ret != 0 || listen(fd, GT_SHARE_BACKLOG) != 0) {
+        if (ret == 0) unlink(socket_path);
+        close(fd);
+        return -1;
+    }
+    set_nonblocking(fd);
+
+    struct gt_share *share = gt_malloc(sizeof(struct gt_share));
+    char *path = gt_strdup(socket_path);
+    if (!share || !path) {
+        free(share);
+        free(path);
+        unlink(socket_path);
+        close(fd);
+        return -1;
+    }
+    share->listen_fd = fd;
+    share->path = path;
+    share->viewer_input = viewer_input;
+    share->frame = 0;
+    share->viewers = NULL;
+    ctx->share = share;
+    return 0;
+}
+
+void gt_stop_sharing(void) {
+    gt_context_t *ctx = gt_ctx();
+    struct gt_share *share = ctx->share;
+    if (!share) return;
+    ctx->share = NULL;
+
+    while (share->viewers) drop_viewer(share, share->viewers);
+    close(share->listen_fd);
+    unlink(share->path);
+    free(share->path);
+    free(share);
+}
+
+int gt_get_viewer_count(void) {
+    struct gt_share *share = gt_ctx()->share;
+    int count = 0;
+    if (share) {
+        for (struct gt_viewer *viewer = share->viewers; viewer; viewer = viewer->next) count++;
+    }
+    return count;
+}
@@ -0,0 +1,154 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Runtime counters. The hot paths bump plain fields of the context's
+ * counters; percentiles come from log-linear histograms (8 sub-buckets
+ * per power of two, so every bucket is within 12.5% of the values it
+ * holds).
+ *
+ * Input latency is measured from the moment gt_wait_event() decodes a
+ * key to the write() that completes the first frame rendered after it.
+ * When several keys arrive before a frame, the oldest one is measured.
+ */
+
+static unsigned hist_bucket(uint64_t value) {
+    if (value < GT_HIST_SUB_BUCKETS) return (unsigned)value;
+
+    unsigned msb = 63 - (unsigned)__builtin_clzll(value);
+    unsigned sub = (unsigned)(value >> (msb - 3)) & (GT_HIST_SUB_BUCKETS - 1);
+    unsigned bucket = (msb - 2) * GT_HIST_SUB_BUCKETS + sub;
+    return bucket < GT_HIST_BUCKETS ? bucket : GT_HIST_BUCKETS - 1;
+}
+
+// Smallest value that falls into `bucket`
+static uint64_t hist_bucket_value(unsigned bucket) {
+    if (bucket < GT_HIST_SUB_BUCKETS) return bucket;
+
+    unsigned msb = bucket / GT_HIST_SUB_BUCKETS + 2;
+    uint64_t sub = bucket % GT_HIST_SUB_BUCKETS;
+    return (GT_HIST_SUB_BUCKETS + sub) << (msb - 3);
+}
+
+void gt_hist_record(struct gt_histogram *hist, uint64_t value) {
+    hist->counts[hist_bucket(value)]++;
+    hist->total++;
+    if (value > hist->max) hist->max = value;
+}
+
+uint64_t gt_hist_percentile(const struct gt_histogram *hist, double percentile) {
+    if (hist->total == 0) return 0;
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)hist->total);
+    if (rank >= hist->total) rank = hist->total - 1;
+
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < GT_HIST_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen > rank) {
+            uint64_t value = hist_bucket_value(i);
+            return value < hist->max ? value : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+void gt_stats_frame_time(uint64_t ns) {
+    gt_hist_record(&gt_ctx()->stats.frame_times, ns);
+}
+
+void gt_stats_input_event(uint64_t ns) {
+    if (gt_ctx()->stats.input_pending_ns == 0) gt_ctx()->stats.input_pending_ns = ns;
+}
+
+uint64_t gt_stats_take_input(void) {
+    struct gt_stats_state *st = &gt_ctx()->stats;
+    uint64_t ns = st->input_pending_ns;
+    st->input_pending_ns = 0;
+    return ns;
+}
+
+void gt_stats_input_latency(uint64_t ns) {
+    struct gt_stats_state *st = &gt_ctx()->stats;
+    gt_hist_record(&st->input_latency, ns);
+    if (st->latency_overlay) gt_request_frame();
+}
+
+uint64_t gt_get_input_latency(double percentile) {
+    return gt_hist_percentile(&gt_ctx()->stats.input_latency, percentile);
+}
+
+void gt_set_latency_overlay(bool show) {
+    struct gt_stats_state *st = &gt_ctx()->stats;
+    st->latency_overlay = show;
+    gt_request_frame();
+}
+
+// Text of the latency overlay, 0 when it is turned off
+size_t gt_stats_overlay_text(char *buf, size_t size) {
+    struct gt_stats_state *st = &gt_ctx()->stats;
+    if (!st->latency_overlay) return 0;
+
+    int len = snprintf(buf, size, " lat p50 %lluus p99 %lluus max %lluus ",
+                       (unsigned long long)(gt_hist_percentile(&st->input_latency, 50.0) / 1000),
+                       (unsigned long long)(gt_hist_percentile(&st->input_latency, 99.0) / 1000),
+                       (unsigned long long)(st->input_latency.max / 1000));
+    if (len < 0) return 0;
+    return (size_t)len < size ? (size_t)len : size - 1;
+}
+
+void gt_get_stats(gt_stats_t *stats) {
+    struct gt_stats_state *st = &gt_ctx()->stats;
+    if (!stats) return;
+
+    *stats = gt_ctx()->counters;
+    stats->frame_time_p50_ns = gt_hist_percentile(&st->frame_times, 50.0);
+    stats->frame_time_p99_ns = gt_hist_percentile(&st->frame_times, 99.0);
+    stats->frame_time_max_ns = st->frame_times.max;
+    stats->input_latency_p50_ns = gt_hist_percentile(&st->input_latency, 50.0);
+    stats->input_latency_p99_ns = gt_hist_percentile(&st->input_latency, 99.0);
+    stats->input_latency_max_ns = st->input_latency.max;
+}
+
+void gt_reset_stats(void) {
+    struct gt_stats_state *st = &gt_ctx()->stats;
+    memset(&gt_ctx()->counters, 0, sizeof(gt_stats_t));
+    memset(&st->frame_times, 0, sizeof(st->frame_times));
+    memset(&st->input_latency, 0, sizeof(st->input_latency));
+}
+
+void *gt_malloc(size_t size) {
+    gt_ctx()->counters.allocations++;
+    return malloc(size);
+}
+
+void *gt_realloc(void *ptr, size_t size) {
+    gt_ctx()->counters.allocations++;
+    return realloc(ptr, size);
+}
+
+char *gt_strdup(const char *str) {
+    size_t len = strlen(str) + 1;
+    char *copy = gt_malloc(len);
+    if (copy) memcpy(copy, str, len);
+    return copy;
+}
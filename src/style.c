@@ -0,0 +1,83 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <pthread.h>
+#include <stdio.h>
+
+/*
+ * Style table. Each (fg, bg, attr) combination in use is interned once
+ * into a small ID together with the SGR sequence that selects it, so
+ * widgets keep two bytes instead of three enums and the encoder turns a
+ * style change into a copy. The table is shared by all contexts: IDs
+ * are handed out under a lock and never change, and a key's slot in the
+ * index is published only after its entry is complete, so lookups of a
+ * style already interned take no lock.
+ */
+
+#define GT_STYLE_ATTRS (GT_ATTR_INVISIBLE << 1)
+#define GT_STYLE_KEYS (GT_COLOR_MAX * GT_COLOR_MAX * GT_STYLE_ATTRS)
+
+static struct gt_style styles[GT_STYLE_KEYS];
+static uint16_t style_index[GT_STYLE_KEYS];     // ID + 1, 0 not interned
+static unsigned style_count;
+static pthread_mutex_t style_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void build_sgr(struct gt_style *style) {
+    char *seq = style->sgr;
+    size_t size = sizeof(style->sgr);
+    int len = snprintf(seq, size, "\033[0");
+
+    if (style->attr & GT_ATTR_BOLD) len += snprintf(seq + len, size - len, ";1");
+    if (style->attr & GT_ATTR_DIM) len += snprintf(seq + len, size - len, ";2");
+    if (style->attr & GT_ATTR_UNDERLINE) len += snprintf(seq + len, size - len, ";4");
+    if (style->attr & GT_ATTR_BLINK) len += snprintf(seq + len, size - len, ";5");
+    if (style->attr & GT_ATTR_REVERSE) len += snprintf(seq + len, size - len, ";7");
+    if (style->attr & GT_ATTR_INVISIBLE) len += snprintf(seq + len, size - len, ";8");
+    if (style->fg != GT_COLOR_DEFAULT) len += snprintf(seq + len, size - len, ";3%d", style->fg);
+    if (style->bg != GT_COLOR_DEFAULT) len += snprintf(seq + len, size - len, ";4%d", style->bg);
+    len += snprintf(seq + len, size - len, "m");
+    style->sgr_len = (uint8_t)len;
+}
+
+// Colors out of range draw in the default color, unknown attributes are dropped
+gt_style_t gt_style_intern(gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+    if ((unsigned)fg >= GT_COLOR_MAX) fg = GT_COLOR_DEFAULT;
+    if ((unsigned)bg >= GT_COLOR_MAX) bg = GT_COLOR_DEFAULT;
+    unsigned key = ((unsigned)fg * GT_COLOR_MAX + (unsigned)bg) * GT_STYLE_ATTRS + ((unsigned)attr & (GT_STYLE_ATTRS - 1));
+
+    uint16_t slot = __atomic_load_n(&style_index[key], __ATOMIC_ACQUIRE);
+    if (slot) return (gt_style_t)(slot - 1);
+
+    pthread_mutex_lock(&style_lock);
+    slot = style_index[key];
+    if (!slot) {
+        struct gt_style *style = &styles[style_count];
+        style->fg = (uint8_t)fg;
+        style->bg = (uint8_t)bg;
+        style->attr = (uint8_t)(attr & (GT_STYLE_ATTRS - 1));
+        build_sgr(style);
+        slot = (uint16_t)++style_count;
+        __atomic_store_n(&style_index[key], slot, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&style_lock);
+    return (gt_style_t)(slot - 1);
+}
+
+const struct gt_style *gt_style_get(gt_style_t id) {
+    return &styles[id];
+}
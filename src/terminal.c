@@ -16,71 +16,191 @@
     51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 */
 #include "gtlib.h"
-#include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <termios.h>
 #include <sys/ioctl.h>
+#include <sys/select.h>
 
-static struct termios orig_termios;
-static int term_width = 80;
-static int term_height = 24;
+#define GT_QUERY_TIMEOUT_MS 200
+
+/*
+ * Ask whether the terminal supports synchronized updates (DEC private
+ * mode 2026) with DECRQM, and whether it implements REP: one character
+ * is printed at column 1, repeated twice, and the cursor position report
+ * says column 4 only if the repeat worked. A DA1 request is sent last:
+ * every terminal answers DA1, so its reply ends the wait even when the
+ * other requests are ignored. Anything else read meanwhile is kept as
+ * keyboard input.
+ */
+static void detect_features(bool *sync_update, bool *repeat) {
+    gt_context_t *ctx = gt_ctx();
+    static const char query[] = "\033[?2026$p\r.\033[2b\033[6n\r\033[K\033[c";
+    char buf[256];
+    size_t len = 0;
+    bool da_seen = false;
+    int mode = 0;
+    int column = 0;
+    
+    *sync_update = *repeat = false;
+    if (!isatty(ctx->in_fd) || !isatty(ctx->out_fd)) return;
+    if (write(ctx->out_fd, query, sizeof(query) - 1) != (ssize_t)(sizeof(query) - 1)) return;
+    
+    uint64_t deadline = gt_now_ns() + GT_QUERY_TIMEOUT_MS * 1000000ull;
+    while (!da_seen && len < sizeof(buf)) {
+        uint64_t now = gt_now_ns();
+        if (now >= deadline) break;
+        
+        fd_set readfds;
+        struct timeval tv = { 0, (long)((deadline - now) / 1000) };
+        FD_ZERO(&readfds);
+        FD_SET(ctx->in_fd, &readfds);
+        if (select(ctx->in_fd + 1, &readfds, NULL, NULL, &tv) <= 0) break;
+        
+        ssize_t n = read(ctx->in_fd, buf + len, sizeof(buf) - len);
+        if (n <= 0) break;
+        len += (size_t)n;
+        
+        // Look for "ESC [ ? ... c" (DA1), "ESC [ ? 2026 ; Ps $ y" (DECRPM)
+        // and "ESC [ row ; col R" (CPR)
+        for (size_t i = 0; i + 2 < len; i++) {
+            if (buf[i] != 27 || buf[i + 1] != '[') continue;
+            size_t end = i + 2;
+            while (end < len && (buf[end] < 0x40 || buf[end] > 0x7e)) end++;
+            if (end >= len) break;
+            if (buf[i + 2] == '?') {
+                if (buf[end] == 'c') da_seen = true;
+                if (buf[end] == 'y' && strncmp(buf + i + 3, "2026;", 5) == 0) mode = buf[i + 8] - '0';
+            } else if (buf[end] == 'R') {
+                const char *semi = memchr(buf + i + 2, ';', end - i - 2);
+                column = 0;
+                for (const char *p = semi ? semi + 1 : buf + end; p < buf + end; p++) column = column * 10 + (*p - '0');
+            }
+        }
+    }
+    
+    // Hand everything that is not one of the replies to the input decoder
+    size_t i = 0;
+    while (i < len) {
+        if (i + 1 < len && buf[i] == 27 && buf[i + 1] == '[') {
+            size_t end = i + 2;
+            while (end < len && (buf[end] < 0x40 || buf[end] > 0x7e)) end++;
+            bool private = i + 2 < len && buf[i + 2] == '?';
+            if (end < len && ((private && (buf[end] == 'c' || buf[end] == 'y')) || (!private && buf[end] == 'R'))) {
+                i = end + 1;
+                continue;
+            }
+        }
+        size_t start = i++;
+        while (i < len && buf[i] != 27) i++;
+        gt_input_push(buf + start, i - start);
+    }
+    
+    // 1 = set, 2 = reset; 0 and 4 mean the mode is unknown or unusable
+    *sync_update = mode == 1 || mode == 2;
+    *repeat = column == 4;
+}
 
 int gt_init(void) {
-    tcgetattr(STDIN_FILENO, &orig_termios);
+    gt_context_t *ctx = gt_ctx();
+    if (ctx->initialized) return 0;
+    
+    gt_cells_init();
     
-    struct termios raw = orig_termios;
-    raw.c_lflag &= ~(ECHO | ICANON);
-    tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+    // Headless contexts keep their size and encode for an xterm
+    bool sync_update = true, repeat = true;
+    if (!ctx->headless) {
+        tcgetattr(ctx->in_fd, &ctx->orig_termios);
+        
+        struct termios raw = ctx->orig_termios;
+        raw.c_lflag &= ~(ECHO | ICANON);
+        tcsetattr(ctx->in_fd, TCSAFLUSH, &raw);
+        
+        struct winsize ws;
+        if (ioctl(ctx->out_fd, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+            ctx->term_width = ws.ws_col;
+            ctx->term_height = ws.ws_row;
+        }
+        
+        detect_features(&sync_update, &repeat);
+    }
+    gt_screen_set_sync_update(sync_update);
+    gt_screen_set_repeat(repeat);
     
-    struct winsize ws;
-    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0) {
-        term_width = ws.ws_col;
-        term_height = ws.ws_row;
+    if (gt_screen_resize(ctx->term_width, ctx->term_height) != 0 || gt_output_open(ctx->out_fd) != 0) {
+        gt_screen_free();
+        if (!ctx->headless) tcsetattr(ctx->in_fd, TCSAFLUSH, &ctx->orig_termios);
+        return -1;
     }
     
-    printf("\033[2J\033[H\033[?25l");
-    fflush(stdout);
+    // Without the pipe, frames other threads request wait for the next event
+    gt_frame_open_wakeup();
     
+    gt_output_puts("\033[2J\033[H\033[?25l");
+    gt_output_drain();
+    
+    ctx->initialized = true;
     return 0;
 }
 
 void gt_cleanup(void) {
-    printf("\033[2J\033[H\033[?25h");
-    fflush(stdout);
-    tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios);
+    gt_context_t *ctx = gt_ctx();
+    if (!ctx->initialized) return;
+    
+    gt_stop_recording();
+    gt_stop_sharing();
+    gt_output_puts("\033[0m\033[2J\033[H\033[?25h");
+    gt_output_close();
+    gt_screen_free();
+    if (!ctx->headless) tcsetattr(ctx->in_fd, TCSAFLUSH, &ctx->orig_termios);
+    
+    ctx->initialized = false;
 }
 
 void gt_clear_window(gt_window_t *window) {
-    if (!window || !window->visible) return;
-    
-    for (int y = 0; y < window->height; y++) {
-        printf("\033[%d;%dH", window->y + y + 1, window->x + 1);
-        for (int x = 0; x < window->width; x++) {
-            printf(" ");
-        }
-    }
-    fflush(stdout);
+    if (!window) return;
+    gt_fill_rect(window, 0, 0, window->width, window->height, ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
 }
 
-void gt_draw_char(gt_window_t *window, int x, int y, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+// Fill a rectangle of the window, clipped to the window
+void gt_fill_rect(gt_window_t *window, int x, int y, int width, int height, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
     if (!window || !window->visible) return;
     
-    int abs_x = window->x + x;
-    int abs_y = window->y + y;
-    
-    if (abs_x < 0 || abs_x >= term_width || abs_y < 0 || abs_y >= term_height) return;
+    if (x < 0) { width += x; x = 0; }
+    if (y < 0) { height += y; y = 0; }
+    if (x + width > window->width) width = window->width - x;
+    if (y + height > window->height) height = window->height - y;
+    if (width <= 0 || height <= 0) return;
     
-    printf("\033[%d;%dH", abs_y + 1, abs_x + 1);
+    gt_screen_fill(window->x + x, window->y + y, width, height, ch, fg, bg, attr);
+}
+
+// Copy an application rendered block of cells, `stride` cells per row
+void gt_blit_cells(gt_window_t *window, int x, int y, int width, int height, const gt_cell_t *cells, size_t stride) {
+    if (!window || !window->visible || !cells) return;
     
-    if (attr & GT_ATTR_BOLD) printf("\033[1m");
-    if (attr & GT_ATTR_UNDERLINE) printf("\033[4m");
-    if (attr & GT_ATTR_REVERSE) printf("\033[7m");
+    int left = x < 0 ? -x : 0;
+    int top = y < 0 ? -y : 0;
+    if (x + width > window->width) width = window->width - x;
+    if (y + height > window->height) height = window->height - y;
+    if (width - left <= 0 || height - top <= 0) return;
     
-    if (fg != GT_COLOR_DEFAULT) printf("\033[3%dm", fg);
-    if (bg != GT_COLOR_DEFAULT) printf("\033[4%dm", bg);
+    gt_screen_blit(window->x + x + left, window->y + y + top, width - left, height - top,
+                   cells + (size_t)top * stride + (size_t)left, stride);
+}
+
+void gt_draw_hline(gt_window_t *window, int x, int y, int length, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+    gt_fill_rect(window, x, y, length, 1, ch, fg, bg, attr);
+}
+
+void gt_draw_vline(gt_window_t *window, int x, int y, int length, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+    gt_fill_rect(window, x, y, 1, length, ch, fg, bg, attr);
+}
+
+void gt_draw_char(gt_window_t *window, int x, int y, char ch, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+    if (!window || !window->visible) return;
     
-    printf("%c\033[0m", ch);
-    fflush(stdout);
+    gt_screen_put(window->x + x, window->y + y, ch, fg, bg, attr);
 }
 
 void gt_draw_string(gt_window_t *window, int x, int y, const char *str, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
@@ -94,15 +214,10 @@ void gt_draw_string(gt_window_t *window, int x, int y, const char *str, gt_color
 void gt_draw_border(gt_window_t *window, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
     if (!window || !window->visible) return;
     
-    for (int x = 0; x < window->width; x++) {
-        gt_draw_char(window, x, 0, '-', fg, bg, attr);
-        gt_draw_char(window, x, window->height - 1, '-', fg, bg, attr);
-    }
-    
-    for (int y = 0; y < window->height; y++) {
-        gt_draw_char(window, 0, y, '|', fg, bg, attr);
-        gt_draw_char(window, window->width - 1, y, '|', fg, bg, attr);
-    }
+    gt_draw_hline(window, 0, 0, window->width, '-', fg, bg, attr);
+    gt_draw_hline(window, 0, window->height - 1, window->width, '-', fg, bg, attr);
+    gt_draw_vline(window, 0, 0, window->height, '|', fg, bg, attr);
+    gt_draw_vline(window, window->width - 1, 0, window->height, '|', fg, bg, attr);
     
     gt_draw_char(window, 0, 0, '+', fg, bg, attr);
     gt_draw_char(window, window->width - 1, 0, '+', fg, bg, attr);
@@ -112,11 +227,13 @@ void gt_draw_border(gt_window_t *window, gt_color_t fg, gt_color_t bg, gt_attr_t
 
 void gt_refresh_window(gt_window_t *window) {
     (void)window;
-    fflush(stdout);
+    gt_refresh_all();
 }
 
 void gt_refresh_all(void) {
-    fflush(stdout);
+    uint64_t start = gt_now_ns();
+    gt_screen_flush();
+    gt_stats_frame_time(gt_now_ns() - start);
 }
 
 const char *gt_get_version(void) {
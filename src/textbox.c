@@ -0,0 +1,279 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Editable textbox backed by a gap buffer. The gap is only moved to the
+ * cursor when text is inserted or deleted, so cursor movement is O(1).
+ * The buffer always keeps one spare byte so the text can be handed out
+ * NUL-terminated by gt_get_widget_text().
+ */
+
+#define GT_TEXTBOX_MIN_SIZE 16
+
+struct gt_textbox {
+    char *buf;
+    size_t size;                // bytes allocated, gap included
+    size_t gap_start, gap_end;
+    size_t max_length;          // 0 means unlimited
+    size_t cursor;              // logical position, 0..length
+    size_t scroll;              // first visible logical position
+    int damage_col;             // first visible column to repaint, -1 none
+};
+
+static size_t textbox_length(const struct gt_textbox *tb) {
+    return tb->size - (tb->gap_end - tb->gap_start);
+}
+
+static char textbox_char_at(const struct gt_textbox *tb, size_t pos) {
+    return pos < tb->gap_start ? tb->buf[pos] : tb->buf[pos + tb->gap_end - tb->gap_start];
+}
+
+static void textbox_move_gap(struct gt_textbox *tb, size_t pos) {
+    if (pos < tb->gap_start) {
+        size_t n = tb->gap_start - pos;
+        memmove(tb->buf + tb->gap_end - n, tb->buf + pos, n);
+        tb->gap_start -= n;
+        tb->gap_end -= n;
+    } else if (pos > tb->gap_start) {
+        size_t n = pos - tb->gap_start;
+        memmove(tb->buf + tb->gap_start, tb->buf + tb->gap_end, n);
+        tb->gap_start += n;
+        tb->gap_end += n;
+    }
+}
+
+// Make room for `n` more bytes while keeping the spare NUL byte
+static bool textbox_reserve(struct gt_textbox *tb, size_t n) {
+    if (tb->gap_end - tb->gap_start > n) return true;
+
+    size_t len = textbox_length(tb);
+    size_t size = tb->size * 2;
+    if (size < len + n + 1) size = len + n + 1;
+
+    char *buf = gt_malloc(size);
+    if (!buf) return false;
+
+    size_t tail = tb->size - tb->gap_end;
+    memcpy(buf, tb->buf, tb->gap_start);
+    memcpy(buf + size - tail, tb->buf + tb->gap_end, tail);
+    free(tb->buf);
+
+    tb->buf = buf;
+    tb->gap_end = size - tail;
+    tb->size = size;
+    return true;
+}
+
+static int textbox_inner_width(const gt_widget_t *widget) {
+    return widget->width > 2 ? widget->width - 2 : 0;
+}
+
+static void textbox_damage(struct gt_textbox *tb, size_t pos) {
+    int col = pos > tb->scroll ? (int)(pos - tb->scroll) : 0;
+    if (tb->damage_col < 0 || col < tb->damage_col) tb->damage_col = col;
+}
+
+// Keep the cursor inside the visible span, scrolling horizontally
+static void textbox_follow_cursor(gt_widget_t *widget) {
+    struct gt_textbox *tb = widget->ext.textbox;
+    size_t inner = (size_t)textbox_inner_width(widget);
+    size_t scroll = tb->scroll;
+
+    if (inner == 0) return;
+    if (tb->cursor < scroll) {
+        scroll = tb->cursor;
+    } else if (tb->cursor >= scroll + inner) {
+        scroll = tb->cursor - inner + 1;
+    }
+
+    if (scroll != tb->scroll) {
+        tb->scroll = scroll;
+        tb->damage_col = 0;
+    }
+}
+
+static struct gt_textbox *textbox_of(gt_widget_t *widget) {
+    if (!widget || widget->type != GT_WIDGET_TEXTBOX) return NULL;
+    return widget->ext.textbox;
+}
+
+int gt_textbox_init(gt_widget_t *widget, const char *text, int max_length) {
+    struct gt_textbox *tb = gt_malloc(sizeof(struct gt_textbox));
+    if (!tb) return -1;
+
+    tb->max_length = max_length > 0 ? (size_t)max_length : 0;
+    tb->size = tb->max_length ? tb->max_length + 1 : GT_TEXTBOX_MIN_SIZE;
+    tb->buf = gt_malloc(tb->size);
+    if (!tb->buf) {
+        free(tb);
+        return -1;
+    }
+    tb->gap_start = 0;
+    tb->gap_end = tb->size;
+    tb->cursor = 0;
+    tb->scroll = 0;
+    tb->damage_col = -1;
+
+    widget->ext.textbox = tb;
+    gt_textbox_set_text(widget, text);
+    return 0;
+}
+
+void gt_textbox_set_text(gt_widget_t *widget, const char *text) {
+    struct gt_textbox *tb = textbox_of(widget);
+    if (!tb) return;
+
+    size_t len = text ? strlen(text) : 0;
+    if (tb->max_length && len > tb->max_length) len = tb->max_length;
+
+    // Reserve before dropping the old text, which stays if this fails
+    if (!textbox_reserve(tb, len)) return;
+    tb->gap_start = 0;
+    tb->gap_end = tb->size;
+
+    if (len > 0) memcpy(tb->buf, text, len);
+    tb->gap_start = len;
+    tb->cursor = len;
+    tb->scroll = 0;
+    textbox_follow_cursor(widget);
+    gt_invalidate_widget(widget);
+}
+
+const char *gt_textbox_get_text(gt_widget_t *widget) {
+    struct gt_textbox *tb = textbox_of(widget);
+    if (!tb) return NULL;
+
+    textbox_move_gap(tb, textbox_length(tb));
+    tb->buf[tb->gap_start] = '\0';
+    return tb->buf;
+}
+
+void gt_textbox_destroy(gt_widget_t *widget) {
+    struct gt_textbox *tb = textbox_of(widget);
+    if (!tb) return;
+    free(tb->buf);
+    free(tb);
+    widget->ext.textbox = NULL;
+}
+
+static bool textbox_insert(gt_widget_t *widget, char ch) {
+    struct gt_textbox *tb = widget->ext.textbox;
+
+    if (tb->max_length && textbox_length(tb) >= tb->max_length) return false;
+    if (!textbox_reserve(tb, 1)) return false;
+
+    textbox_move_gap(tb, tb->cursor);
+    tb->buf[tb->gap_start++] = ch;
+    textbox_damage(tb, tb->cursor);
+    tb->cursor++;
+    return true;
+}
+
+static bool textbox_delete(gt_widget_t *widget, size_t pos) {
+    struct gt_textbox *tb = widget->ext.textbox;
+
+    if (pos >= textbox_length(tb)) return false;
+
+    textbox_move_gap(tb, pos);
+    tb->gap_end++;
+    textbox_damage(tb, pos);
+    tb->cursor = pos;
+    return true;
+}
+
+static bool textbox_move_cursor(gt_widget_t *widget, size_t pos) {
+    struct gt_textbox *tb = widget->ext.textbox;
+    if (pos == tb->cursor) return false;
+
+    // Both the old and the new cursor cell change appearance
+    textbox_damage(tb, tb->cursor < pos ? tb->cursor : pos);
+    tb->cursor = pos;
+    return true;
+}
+
+// True if the key changed the text or moved the cursor
+bool gt_textbox_handle_key(gt_widget_t *widget, gt_key_t key) {
+    struct gt_textbox *tb = textbox_of(widget);
+    if (!tb) return false;
+
+    bool changed = false;
+    switch (key) {
+        case GT_KEY_LEFT:
+            changed = tb->cursor > 0 && textbox_move_cursor(widget, tb->cursor - 1);
+            break;
+        case GT_KEY_RIGHT:
+            changed = tb->cursor < textbox_length(tb) && textbox_move_cursor(widget, tb->cursor + 1);
+            break;
+        case GT_KEY_HOME:
+            changed = textbox_move_cursor(widget, 0);
+            break;
+        case GT_KEY_END:
+            changed = textbox_move_cursor(widget, textbox_length(tb));
+            break;
+        case GT_KEY_BACKSPACE:
+        case GT_KEY_DELETE:
+            changed = tb->cursor > 0 && textbox_delete(widget, tb->cursor - 1);
+            break;
+        case GT_KEY_FORWARD_DELETE:
+            changed = textbox_delete(widget, tb->cursor);
+            break;
+        default:
+            if (key < 32 || key > 126) return false;
+            changed = textbox_insert(widget, (char)key);
+            break;
+    }
+    if (!changed) return false;
+
+    textbox_follow_cursor(widget);
+    if (tb->damage_col >= 0) gt_request_frame();
+    return true;
+}
+
+size_t gt_textbox_get_cursor(gt_widget_t *widget) {
+    struct gt_textbox *tb = textbox_of(widget);
+    return tb ? tb->cursor : 0;
+}
+
+// Paint the edit line from visible column `from` to its end
+void gt_textbox_render_content(gt_window_t *window, gt_widget_t *widget, int from) {
+    struct gt_textbox *tb = textbox_of(widget);
+    if (!tb) return;
+
+    gt_color_t fg = widget->focused ? GT_COLOR_BLACK : GT_COLOR_WHITE;
+    gt_color_t bg = widget->focused ? GT_COLOR_WHITE : GT_COLOR_BLACK;
+    int inner = textbox_inner_width(widget);
+    int row = widget->y + (widget->height > 2 ? 1 : 0);
+    size_t len = textbox_length(tb);
+
+    for (int col = from < 0 ? 0 : from; col < inner; col++) {
+        size_t pos = tb->scroll + (size_t)col;
+        char ch = pos < len ? textbox_char_at(tb, pos) : ' ';
+        gt_attr_t attr = widget->focused && pos == tb->cursor ? GT_ATTR_REVERSE : GT_ATTR_NORMAL;
+        gt_draw_char(window, widget->x + 1 + col, row, ch, fg, bg, attr);
+    }
+    tb->damage_col = -1;
+}
+
+void gt_textbox_render_damage(gt_window_t *window, gt_widget_t *widget) {
+    struct gt_textbox *tb = textbox_of(widget);
+    if (!tb || tb->damage_col < 0 || !widget->visible) return;
+    gt_textbox_render_content(window, widget, tb->damage_col);
+}
@@ -0,0 +1,120 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef GT_TRACE
+
+/*
+ * Span tracing. Every thread records into its own ring, so recording is
+ * a couple of plain stores plus a release store of the head; the rings
+ * are linked into a global list once, with a CAS, for the dumper. When
+ * a ring wraps the oldest spans are overwritten. Timestamps are raw
+ * clock ticks, calibrated against gt_now_ns() only when dumping.
+ */
+
+#define GT_TRACE_RING_SIZE 16384    // Must be a power of two
+
+struct gt_trace_span {
+    const char *name;
+    uint64_t start, end;
+};
+
+struct gt_trace_ring {
+    struct gt_trace_span spans[GT_TRACE_RING_SIZE];
+    uint64_t head;
+    uint32_t tid;
+    struct gt_trace_ring *next;
+};
+
+static struct gt_trace_ring *trace_rings = NULL;
+static uint32_t trace_next_tid = 1;
+static uint64_t trace_base_ticks = 0;
+static uint64_t trace_base_ns = 0;
+static __thread struct gt_trace_ring *trace_ring = NULL;
+
+static struct gt_trace_ring *trace_ring_create(void) {
+    struct gt_trace_ring *ring = calloc(1, sizeof(struct gt_trace_ring));
+    if (!ring) return NULL;
+
+    ring->tid = __atomic_fetch_add(&trace_next_tid, 1, __ATOMIC_RELAXED);
+    if (ring->tid == 1) {
+        trace_base_ns = gt_now_ns();
+        trace_base_ticks = gt_trace_clock();
+    }
+    ring->next = __atomic_load_n(&trace_rings, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&trace_rings, &ring->next, ring, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    return ring;
+}
+
+void gt_trace_record(const char *name, uint64_t start, uint64_t end) {
+    struct gt_trace_ring *ring = trace_ring;
+    if (!ring) {
+        ring = trace_ring = trace_ring_create();
+        if (!ring) return;
+    }
+
+    uint64_t head = ring->head;
+    struct gt_trace_span *span = &ring->spans[head & (GT_TRACE_RING_SIZE - 1)];
+    span->name = name;
+    span->start = start;
+    span->end = end;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+// Spans still being written by other threads may come out torn
+int gt_trace_dump(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) return -1;
+
+    uint64_t ticks = gt_trace_clock() - trace_base_ticks;
+    uint64_t ns = gt_now_ns() - trace_base_ns;
+    double us_per_tick = ticks > 0 ? (double)ns / (double)ticks / 1000.0 : 0.001;
+    double base_us = (double)trace_base_ns / 1000.0;
+
+    bool first = true;
+    fprintf(file, "{\"traceEvents\":[");
+    for (struct gt_trace_ring *ring = __atomic_load_n(&trace_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        uint64_t tail = head > GT_TRACE_RING_SIZE ? head - GT_TRACE_RING_SIZE : 0;
+
+        for (uint64_t i = tail; i < head; i++) {
+            const struct gt_trace_span *span = &ring->spans[i & (GT_TRACE_RING_SIZE - 1)];
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                    first ? "" : ",", span->name,
+                    base_us + (double)(int64_t)(span->start - trace_base_ticks) * us_per_tick,
+                    (double)(span->end - span->start) * us_per_tick, ring->tid);
+            first = false;
+        }
+    }
+    fprintf(file, "\n]}\n");
+
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+#else
+
+int gt_trace_dump(const char *path) {
+    (void)path;
+    return -1;
+}
+
+#endif
@@ -17,13 +17,26 @@
 */
 #include "gtlib.h"
 #include <stdio.h>
+#include <time.h>
 
 void gt_set_cursor_position(int x, int y) {
-    printf("\033[%d;%dH", y + 1, x + 1);
-    fflush(stdout);
+    char seq[32];
+    int len = snprintf(seq, sizeof(seq), "\033[%d;%dH", y + 1, x + 1);
+    
+    // Frames move the cursor around, put it back after each one
+    gt_screen_set_cursor(x, y);
+    gt_output_write(seq, (size_t)len);
+    gt_output_drain();
 }
 
 void gt_set_cursor_visibility(bool visible) {
-    printf(visible ? "\033[?25h" : "\033[?25l");
-    fflush(stdout);
+    gt_screen_set_cursor_visible(visible);
+    gt_output_puts(visible ? "\033[?25h" : "\033[?25l");
+    gt_output_drain();
+}
+
+uint64_t gt_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
 }
@@ -22,7 +22,7 @@
 gt_widget_t *gt_create_button(gt_window_t *window, int x, int y, int width, int height, const char *text, gt_button_callback_t callback, void *user_data) {
     if (!window) return NULL;
     
-    gt_widget_t *widget = malloc(sizeof(gt_widget_t));
+    gt_widget_t *widget = gt_malloc(sizeof(gt_widget_t));
     if (!widget) return NULL;
     
     widget->type = GT_WIDGET_BUTTON;
@@ -30,11 +30,14 @@ gt_widget_t *gt_create_button(gt_window_t *window, int x, int y, int width, int
     widget->y = y;
     widget->width = width;
     widget->height = height;
-    widget->text = text ? strdup(text) : NULL;
+    widget->text = text ? gt_strdup(text) : NULL;
+    widget->style = gt_style_intern(GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
     widget->visible = true;
     widget->focused = false;
+    gt_invalidate_widget(widget);
     widget->callback = callback;
     widget->user_data = user_data;
+    widget->layout = NULL;
     widget->next = window->widgets;
     window->widgets = widget;
     
@@ -50,18 +53,20 @@ gt_widget_t *gt_create_button(gt_window_t *window, int x, int y, int width, int
 gt_widget_t *gt_create_label(gt_window_t *window, int x, int y, const char *text, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
     if (!window) return NULL;
     
-    gt_widget_t *widget = malloc(sizeof(gt_widget_t));
+    gt_widget_t *widget = gt_malloc(sizeof(gt_widget_t));
     if (!widget) return NULL;
     
     widget->type = GT_WIDGET_LABEL;
     widget->x = x;
     widget->y = y;
-    widget->text = text ? strdup(text) : NULL;
-    widget->fg = fg;
-    widget->bg = bg;
-    widget->attr = attr;
+    widget->text = text ? gt_strdup(text) : NULL;
+    widget->width = widget->text ? (int)strlen(widget->text) : 0;
+    widget->height = 1;
+    widget->style = gt_style_intern(fg, bg, attr);
     widget->visible = true;
     widget->focused = false;
+    gt_invalidate_widget(widget);
+    widget->layout = NULL;
     widget->next = window->widgets;
     window->widgets = widget;
     
@@ -71,7 +76,7 @@ gt_widget_t *gt_create_label(gt_window_t *window, int x, int y, const char *text
 gt_widget_t *gt_create_textbox(gt_window_t *window, int x, int y, int width, int height, const char *text, int max_length) {
     if (!window) return NULL;
     
-    gt_widget_t *widget = malloc(sizeof(gt_widget_t));
+    gt_widget_t *widget = gt_malloc(sizeof(gt_widget_t));
     if (!widget) return NULL;
     
     widget->type = GT_WIDGET_TEXTBOX;
@@ -79,9 +84,16 @@ gt_widget_t *gt_create_textbox(gt_window_t *window, int x, int y, int width, int
     widget->y = y;
     widget->width = width;
     widget->height = height;
-    widget->text = text ? strdup(text) : NULL;
+    widget->text = NULL;
+    if (gt_textbox_init(widget, text, max_length) != 0) {
+        free(widget);
+        return NULL;
+    }
+    widget->style = gt_style_intern(GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
     widget->visible = true;
     widget->focused = false;
+    gt_invalidate_widget(widget);
+    widget->layout = NULL;
     widget->next = window->widgets;
     window->widgets = widget;
     
@@ -91,26 +103,48 @@ gt_widget_t *gt_create_textbox(gt_window_t *window, int x, int y, int width, int
         widget->focused = true;
     }
     
-    (void)max_length;
     return widget;
 }
 
 void gt_set_widget_text(gt_widget_t *widget, const char *text) {
     if (!widget) return;
+    if (widget->type == GT_WIDGET_TEXTBOX) {
+        gt_textbox_set_text(widget, text);
+        return;
+    }
     if (widget->text) free(widget->text);
-    widget->text = text ? strdup(text) : NULL;
+    widget->text = text ? gt_strdup(text) : NULL;
+    gt_invalidate_widget(widget);
+    if (widget->type == GT_WIDGET_LABEL) gt_layout_widget_changed(widget);
 }
 
 const char *gt_get_widget_text(gt_widget_t *widget) {
+    if (widget && widget->type == GT_WIDGET_TEXTBOX) return gt_textbox_get_text(widget);
     return widget ? widget->text : NULL;
 }
 
 void gt_set_widget_visible(gt_widget_t *widget, bool visible) {
-    if (widget) widget->visible = visible;
+    if (!widget) return;
+    widget->visible = visible;
+    gt_invalidate_widget(widget);
+}
+
+void gt_set_widget_style(gt_widget_t *widget, gt_color_t fg, gt_color_t bg, gt_attr_t attr) {
+    if (!widget) return;
+    gt_style_t style = gt_style_intern(fg, bg, attr);
+    if (style == widget->style) return;
+    widget->style = style;
+    gt_invalidate_widget(widget);
 }
 
 void gt_destroy_widget(gt_widget_t *widget) {
     if (!widget) return;
+    gt_layout_widget_destroyed(widget);
+    if (widget->type == GT_WIDGET_CONSOLE) gt_console_destroy(widget);
+    if (widget->type == GT_WIDGET_TEXTBOX) gt_textbox_destroy(widget);
+    if (widget->type == GT_WIDGET_VIEWPORT) gt_viewport_destroy(widget);
+    if (widget->type == GT_WIDGET_CHART) gt_chart_destroy(widget);
+    if (widget->type == GT_WIDGET_GAUGE) gt_gauge_destroy(widget);
     if (widget->text) free(widget->text);
     free(widget);
 }
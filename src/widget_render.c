@@ -9,6 +9,7 @@
 void gt_render_widget(gt_window_t *window, gt_widget_t *widget) {
     if (!window || !widget || !widget->visible) return;
     
+    GT_TRACE_BEGIN(start);
     switch (widget->type) {
         case GT_WIDGET_BUTTON: {
             // 绘制按钮边框
@@ -16,17 +17,17 @@ void gt_render_widget(gt_window_t *window, gt_widget_t *widget) {
             gt_color_t bg = widget->focused ? GT_COLOR_BLUE : GT_COLOR_DEFAULT;
             
             // 绘制按钮框架
-            for (int y = 0; y < widget->height; y++) {
-                for (int x = 0; x < widget->width; x++) {
-                    char ch = ' ';
-                    if (y == 0 || y == widget->height - 1) {
-                        ch = (x == 0 || x == widget->width - 1) ? '+' : '-';
-                    } else if (x == 0 || x == widget->width - 1) {
-                        ch = '|';
-                    }
-                    gt_draw_char(window, widget->x + x, widget->y + y, ch, fg, bg, GT_ATTR_NORMAL);
-                }
-            }
+            int right = widget->x + widget->width - 1;
+            int bottom = widget->y + widget->height - 1;
+            gt_fill_rect(window, widget->x + 1, widget->y + 1, widget->width - 2, widget->height - 2, ' ', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_hline(window, widget->x, widget->y, widget->width, '-', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_hline(window, widget->x, bottom, widget->width, '-', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_vline(window, widget->x, widget->y + 1, widget->height - 2, '|', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_vline(window, right, widget->y + 1, widget->height - 2, '|', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_char(window, widget->x, widget->y, '+', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_char(window, right, widget->y, '+', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_char(window, widget->x, bottom, '+', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_char(window, right, bottom, '+', fg, bg, GT_ATTR_NORMAL);
             
             // 绘制按钮文本
             if (widget->text) {
@@ -41,8 +42,9 @@ void gt_render_widget(gt_window_t *window, gt_widget_t *widget) {
         
         case GT_WIDGET_LABEL: {
             if (widget->text) {
+                const struct gt_style *style = gt_style_get(widget->style);
                 gt_draw_string(window, widget->x, widget->y, widget->text, 
-                              widget->fg, widget->bg, widget->attr);
+                              style->fg, style->bg, style->attr);
             }
             break;
         }
@@ -51,29 +53,55 @@ void gt_render_widget(gt_window_t *window, gt_widget_t *widget) {
             gt_color_t fg = widget->focused ? GT_COLOR_BLACK : GT_COLOR_WHITE;
             gt_color_t bg = widget->focused ? GT_COLOR_WHITE : GT_COLOR_BLACK;
             
-            // 绘制文本框背景
-            for (int y = 0; y < widget->height; y++) {
-                for (int x = 0; x < widget->width; x++) {
-                    gt_draw_char(window, widget->x + x, widget->y + y, ' ', fg, bg, GT_ATTR_NORMAL);
-                }
-            }
-            
-            // 绘制文本框边框
-            for (int x = 0; x < widget->width; x++) {
-                gt_draw_char(window, widget->x + x, widget->y, '-', fg, bg, GT_ATTR_NORMAL);
-                gt_draw_char(window, widget->x + x, widget->y + widget->height - 1, '-', fg, bg, GT_ATTR_NORMAL);
-            }
-            for (int y = 0; y < widget->height; y++) {
-                gt_draw_char(window, widget->x, widget->y + y, '|', fg, bg, GT_ATTR_NORMAL);
-                gt_draw_char(window, widget->x + widget->width - 1, widget->y + y, '|', fg, bg, GT_ATTR_NORMAL);
-            }
+            // 绘制文本框背景和边框, 每个单元格只写一次
+            gt_fill_rect(window, widget->x + 1, widget->y + 1, widget->width - 2, widget->height - 2, ' ', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_hline(window, widget->x + 1, widget->y, widget->width - 2, '-', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_hline(window, widget->x + 1, widget->y + widget->height - 1, widget->width - 2, '-', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_vline(window, widget->x, widget->y, widget->height, '|', fg, bg, GT_ATTR_NORMAL);
+            gt_draw_vline(window, widget->x + widget->width - 1, widget->y, widget->height, '|', fg, bg, GT_ATTR_NORMAL);
             
             // 绘制文本内容
-            if (widget->text) {
-                gt_draw_string(window, widget->x + 1, widget->y + 1, widget->text, fg, bg, GT_ATTR_NORMAL);
-            }
+            gt_textbox_render_content(window, widget, 0);
             break;
         }
+
+        case GT_WIDGET_CONSOLE:
+            gt_console_render(window, widget);
+            break;
+
+        case GT_WIDGET_VIEWPORT:
+            gt_viewport_render(window, widget);
+            break;
+
+        case GT_WIDGET_CHART:
+            gt_chart_render(window, widget);
+            break;
+
+        case GT_WIDGET_GAUGE:
+            gt_gauge_render(window, widget);
+            break;
+    }
+    widget->dirty = false;
+    GT_TRACE_END(start, "widget_render");
+}
+
+// 只重绘有变化的控件, 文本框编辑时只重绘光标之后的部分
+void gt_render_dirty_widgets(gt_window_t *window) {
+    if (!window) return;
+    
+    gt_layout_update(window);
+    for (gt_widget_t *widget = window->widgets; widget; widget = widget->next) {
+        if (widget->dirty) {
+            gt_render_widget(window, widget);
+        } else if (widget->type == GT_WIDGET_TEXTBOX) {
+            gt_textbox_render_damage(window, widget);
+        } else if (widget->type == GT_WIDGET_VIEWPORT) {
+            gt_viewport_render_changed(window, widget);
+        } else if (widget->type == GT_WIDGET_CHART) {
+            gt_chart_render_changed(window, widget);
+        } else if (widget->type == GT_WIDGET_GAUGE) {
+            gt_gauge_render_changed(window, widget);
+        }
     }
 }
 
@@ -81,6 +109,7 @@ void gt_render_widget(gt_window_t *window, gt_widget_t *widget) {
 void gt_render_all_widgets(gt_window_t *window) {
     if (!window) return;
     
+    gt_layout_update(window);
     gt_widget_t *widget = window->widgets;
     while (widget) {
         gt_render_widget(window, widget);
@@ -131,8 +160,12 @@ void gt_focus_next_widget(gt_window_t *window) {
     
     // 更新焦点
     if (next) {
-        if (current) current->focused = false;
+        if (current) {
+            current->focused = false;
+            gt_invalidate_widget(current);
+        }
         next->focused = true;
+        gt_invalidate_widget(next);
         window->focused_widget = next;
     }
 }
@@ -178,12 +211,20 @@ void gt_focus_prev_widget(gt_window_t *window) {
     
     // 更新焦点
     if (prev && prev != current) {
-        if (current) current->focused = false;
+        if (current) {
+            current->focused = false;
+            gt_invalidate_widget(current);
+        }
         prev->focused = true;
+        gt_invalidate_widget(prev);
         window->focused_widget = prev;
     }
 }
 
+gt_widget_t *gt_get_focused_widget(gt_window_t *window) {
+    return window ? window->focused_widget : NULL;
+}
+
 // 激活当前焦点控件
 void gt_activate_focused_widget(gt_window_t *window) {
     if (!window || !window->focused_widget) return;
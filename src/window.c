@@ -20,6 +20,10 @@
 #include <string.h>
 #include <stdio.h>
 
+gt_window_t *gt_window_list(void) {
+    return gt_ctx()->windows;
+}
+
 /*@ 
   @ requires width > 0 && height > 0;
   @ ensures \result == NULL || (\result->width == width && \result->height == height);
@@ -27,7 +31,8 @@
   @ ensures \result == NULL || \result->visible == false;
   @*/
 gt_window_t *gt_create_window(int x, int y, int width, int height, const char *title) {
-    gt_window_t *window = malloc(sizeof(gt_window_t));
+    gt_context_t *ctx = gt_ctx();
+    gt_window_t *window = gt_malloc(sizeof(gt_window_t));
     if (!window) return NULL;
     
     window->x = x;
@@ -36,7 +41,7 @@ gt_window_t *gt_create_window(int x, int y, int width, int height, const char *t
     window->height = height;
     if (title) {
         size_t len = strlen(title) + 1;
-        window->title = malloc(len);
+        window->title = gt_malloc(len);
         if (window->title) strncpy(window->title, title, len);
     } else {
         window->title = NULL;
@@ -44,6 +49,10 @@ gt_window_t *gt_create_window(int x, int y, int width, int height, const char *t
     window->visible = false;
     window->widgets = NULL;
     window->focused_widget = NULL;
+    window->layout = NULL;
+    window->context = ctx;
+    window->next = ctx->windows;
+    ctx->windows = window;
     
     return window;
 }
@@ -54,6 +63,24 @@ gt_window_t *gt_create_window(int x, int y, int width, int height, const char *t
   @*/
 void gt_destroy_window(gt_window_t *window) {
     if (!window) return;
+    
+    gt_destroy_layout(window->layout);
+    
+    gt_widget_t *widget = window->widgets;
+    while (widget) {
+        gt_widget_t *next = widget->next;
+        gt_destroy_widget(widget);
+        widget = next;
+    }
+    
+    // Unlinked from the list it was created in, whatever context is bound
+    for (gt_window_t **link = &window->context->windows; *link; link = &(*link)->next) {
+        if (*link == window) {
+            *link = window->next;
+            break;
+        }
+    }
+    
     if (window->title) free(window->title);
     free(window);
 }
@@ -63,7 +90,11 @@ void gt_destroy_window(gt_window_t *window) {
   @ ensures window == NULL || window->visible == true;
   @*/
 void gt_show_window(gt_window_t *window) {
-    if (window) window->visible = true;
+    if (!window) return;
+    window->visible = true;
+    for (gt_widget_t *widget = window->widgets; widget; widget = widget->next) {
+        gt_invalidate_widget(widget);
+    }
 }
 
 /*@
@@ -79,7 +110,7 @@ void gt_set_window_title(gt_window_t *window, const char *title) {
     if (window->title) free(window->title);
     if (title) {
         size_t len = strlen(title) + 1;
-        window->title = malloc(len);
+        window->title = gt_malloc(len);
         if (window->title) strncpy(window->title, title, len);
     } else {
         window->title = NULL;
@@ -115,6 +146,7 @@ void gt_resize_window(gt_window_t *window, int width, int height) {
     if (!window) return;
     window->width = width;
     window->height = height;
+    if (window->layout) gt_request_frame();
 }
 
 void gt_get_window_geometry(gt_window_t *window, int *x, int *y, int *width, int *height) {
@@ -0,0 +1,245 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <string.h>
+
+/*
+ * Wire format of a rectangle of cells, the payload of GT_IPC_DRAW_CELLS.
+ * Window content is mostly runs of one cell (blanks, border lines,
+ * filled backgrounds) in a handful of styles, so it is sent as runs:
+ *
+ *   varint x, y, width, height
+ *   runs covering the width * height cells in row order, each one
+ *     varint (count - 1) << 2 | repeat << 1 | restyle
+ *     if restyle: varint style id; if the id is the number of styles
+ *       defined so far, fg, bg and attr bytes follow and define it
+ *     repeat ? one character used count times : count characters
+ *
+ * Runs continue across rows and start in style 0, the default style.
+ * At most GT_WIRE_STYLES_MAX styles are defined per span; once they are
+ * used up, further styles are sent in full every time.
+ */
+
+// Fewest identical cells sent as a repeat run rather than literally
+#define GT_WIRE_REPEAT_MIN 3
+
+#define GT_WIRE_SIZE_MAX 65535
+
+// Open addressing map from packed style to id, twice the size of the table
+#define GT_WIRE_STYLE_SLOTS (2 * GT_WIRE_STYLES_MAX)
+
+struct style_map {
+    uint32_t key[GT_WIRE_STYLE_SLOTS];  // packed style + 1, 0 is free
+    uint16_t id[GT_WIRE_STYLE_SLOTS];
+    int count;
+};
+
+static uint32_t style_key(const gt_cell_t *cell) {
+    return (uint32_t)cell->fg | (uint32_t)cell->bg << 8 | (uint32_t)cell->attr << 16;
+}
+
+static uint8_t *put_varint(uint8_t *out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+    return out;
+}
+
+// Slot of the style, or of the free slot it would go in
+static uint32_t style_slot(const struct style_map *map, uint32_t key) {
+    uint32_t slot = (key * 0x9e3779b1u) >> 16 & (GT_WIRE_STYLE_SLOTS - 1);
+    while (map->key[slot] && map->key[slot] != key) slot = (slot + 1) & (GT_WIRE_STYLE_SLOTS - 1);
+    return slot;
+}
+
+static void style_define(struct style_map *map, uint32_t slot, uint32_t key) {
+    if (map->count >= GT_WIRE_STYLES_MAX) return;
+    map->key[slot] = key;
+    map->id[slot] = (uint16_t)map->count++;
+}
+
+// Writes the style id, defining the style on first use
+static uint8_t *put_style(uint8_t *out, struct style_map *map, const gt_cell_t *cell) {
+    uint32_t key = style_key(cell) + 1;
+    uint32_t slot = style_slot(map, key);
+    if (map->key[slot]) return put_varint(out, map->id[slot]);
+
+    out = put_varint(out, (uint64_t)map->count);
+    *out++ = cell->fg;
+    *out++ = cell->bg;
+    *out++ = cell->attr;
+    style_define(map, slot, key);
+    return out;
+}
+
+// Cell `i` of the span, rows `stride` cells apart
+static const gt_cell_t *span_cell(const gt_cell_t *cells, size_t stride, int width, size_t i) {
+    return &cells[i / (size_t)width * stride + i % (size_t)width];
+}
+
+// Largest encoding of a span of `count` cells: the rectangle, then one
+// run per cell, each with a new style
+size_t gt_wire_cells_bound(size_t count) {
+    return 4 * 5 + count * (5 + 2 + 3 + 1);
+}
+
+// Encode a width x height rectangle at (x, y) into out, which holds at
+// least gt_wire_cells_bound() bytes. Returns the bytes used
+size_t gt_wire_encode_cells(const gt_cell_t *cells, size_t stride, int x, int y, int width, int height, uint8_t *out) {
+    if (width <= 0 || height <= 0 || width > GT_WIRE_SIZE_MAX || height > GT_WIRE_SIZE_MAX || x < 0 || y < 0) return 0;
+
+    uint8_t *p = out;
+    p = put_varint(p, (uint64_t)x);
+    p = put_varint(p, (uint64_t)y);
+    p = put_varint(p, (uint64_t)width);
+    p = put_varint(p, (uint64_t)height);
+
+    // Style 0 is the default style, known to the decoder
+    struct style_map map;
+    memset(map.key, 0, sizeof(map.key));
+    map.count = 0;
+    gt_cell_t blank = { ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+    uint32_t pen = style_key(&blank);
+    style_define(&map, style_slot(&map, pen + 1), pen + 1);
+
+    size_t count = (size_t)width * (size_t)height;
+    size_t i = 0;
+    while (i < count) {
+        const gt_cell_t *cell = span_cell(cells, stride, width, i);
+        uint32_t style = style_key(cell);
+
+        // A run of one cell, or characters in one style up to the next such run
+        size_t run = 1;
+        while (i + run < count && memcmp(span_cell(cells, stride, width, i + run), cell, sizeof(gt_cell_t)) == 0) run++;
+        bool repeat = run >= GT_WIRE_REPEAT_MIN;
+        if (!repeat) {
+            run = 1;
+            size_t same = 1;
+            while (i + run < count) {
+                const gt_cell_t *next = span_cell(cells, stride, width, i + run);
+                if (style_key(next) != style) break;
+                const gt_cell_t *prev = span_cell(cells, stride, width, i + run - 1);
+                same = next->ch == prev->ch ? same + 1 : 1;
+                if (same >= GT_WIRE_REPEAT_MIN) {
+                    run -= same - 1;
+                    break;
+                }
+                run++;
+            }
+        }
+
+        bool restyle = style != pen;
+        p = put_varint(p, (uint64_t)(run - 1) << 2 | (uint64_t)repeat << 1 | restyle);
+        if (restyle) p = put_style(p, &map, cell);
+        pen = style;
+
+        if (repeat) {
+            *p++ = (uint8_t)cell->ch;
+        } else {
+            for (size_t k = i; k < i + run; k++) *p++ = (uint8_t)span_cell(cells, stride, width, k)->ch;
+        }
+        i += run;
+    }
+    return (size_t)(p - out);
+}
+
+struct wire_reader {
+    const uint8_t *data;
+    size_t len, off;
+    bool error;
+};
+
+static uint8_t get_byte(struct wire_reader *in) {
+    if (in->off >= in->len) {
+        in->error = true;
+        return 0;
+    }
+    return in->data[in->off++];
+}
+
+static uint64_t get_varint(struct wire_reader *in) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = get_byte(in);
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    in->error = true;
+    return 0;
+}
+
+// Decode a span. With cells NULL only the rectangle is read, so the
+// receiver can size its buffer; otherwise cells holds cap cells and gets
+// them in row order. Returns -1 if the data is corrupt or does not fit
+int gt_wire_decode_cells(const void *data, size_t len, struct gt_wire_span *span, gt_cell_t *cells, size_t cap) {
+    struct wire_reader in = { data, len, 0, false };
+    uint64_t x = get_varint(&in);
+    uint64_t y = get_varint(&in);
+    uint64_t width = get_varint(&in);
+    uint64_t height = get_varint(&in);
+    if (in.error || x > INT32_MAX || y > INT32_MAX || width == 0 || height == 0 ||
+        width > GT_WIRE_SIZE_MAX || height > GT_WIRE_SIZE_MAX) return -1;
+    span->x = (int)x;
+    span->y = (int)y;
+    span->width = (int)width;
+    span->height = (int)height;
+    if (!cells) return 0;
+
+    size_t count = (size_t)width * (size_t)height;
+    if (count > cap) return -1;
+
+    gt_cell_t styles[GT_WIRE_STYLES_MAX];
+    int defined = 1;
+    styles[0] = (gt_cell_t){ ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+    gt_cell_t pen = styles[0];
+
+    size_t i = 0;
+    while (i < count) {
+        uint64_t header = get_varint(&in);
+        uint64_t run = (header >> 2) + 1;
+        if (in.error || run > count - i) return -1;
+
+        if (header & 1) {
+            uint64_t id = get_varint(&in);
+            if (id < (uint64_t)defined) {
+                pen = styles[id];
+            } else if (id == (uint64_t)defined) {
+                pen.fg = get_byte(&in);
+                pen.bg = get_byte(&in);
+                pen.attr = get_byte(&in);
+                if (defined < GT_WIRE_STYLES_MAX) styles[defined++] = pen;
+            } else {
+                return -1;
+            }
+        }
+
+        if (header & 2) {
+            pen.ch = (char)get_byte(&in);
+            for (uint64_t k = 0; k < run; k++) cells[i++] = pen;
+        } else {
+            for (uint64_t k = 0; k < run; k++) {
+                pen.ch = (char)get_byte(&in);
+                cells[i++] = pen;
+            }
+        }
+        if (in.error) return -1;
+    }
+    return in.off == in.len ? 0 : -1;
+}
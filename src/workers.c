@@ -0,0 +1,140 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "gtlib.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+/*
+ * Render workers. A job is a number of independent tasks; the calling
+ * thread and every worker take the next task index from a shared counter
+ * until none are left, so a thread that finishes early simply takes more
+ * of them. Tasks run on other threads and must not call gt_ctx().
+ */
+
+struct gt_workers {
+    pthread_t *threads;
+    int count;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    uint64_t job;               // bumped for every job
+    int active;                 // workers still inside the current job
+    bool stop;
+
+    gt_task_fn fn;
+    void *arg;
+    int tasks;
+    int next;                   // next task index, taken atomically
+};
+
+static void run_tasks(struct gt_workers *workers) {
+    int index;
+    while ((index = __atomic_fetch_add(&workers->next, 1, __ATOMIC_RELAXED)) < workers->tasks) {
+        workers->fn(workers->arg, index);
+    }
+}
+
+static void *worker_main(void *arg) {
+    struct gt_workers *workers = arg;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&workers->lock);
+    for (;;) {
+        while (!workers->stop && workers->job == seen) {
+            pthread_cond_wait(&workers->start, &workers->lock);
+        }
+        if (workers->stop) break;
+        seen = workers->job;
+
+        pthread_mutex_unlock(&workers->lock);
+        run_tasks(workers);
+        pthread_mutex_lock(&workers->lock);
+
+        if (--workers->active == 0) pthread_cond_signal(&workers->done);
+    }
+    pthread_mutex_unlock(&workers->lock);
+    return NULL;
+}
+
+struct gt_workers *gt_workers_create(int threads) {
+    if (threads <= 0) return NULL;
+
+    struct gt_workers *workers = gt_malloc(sizeof(struct gt_workers));
+    pthread_t *ids = gt_malloc((size_t)threads * sizeof(pthread_t));
+    if (!workers || !ids) {
+        free(workers);
+        free(ids);
+        return NULL;
+    }
+
+    workers->threads = ids;
+    workers->count = 0;
+    workers->job = 0;
+    workers->active = 0;
+    workers->stop = false;
+    workers->tasks = 0;
+    workers->next = 0;
+    pthread_mutex_init(&workers->lock, NULL);
+    pthread_cond_init(&workers->start, NULL);
+    pthread_cond_init(&workers->done, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&ids[i], NULL, worker_main, workers) != 0) {
+            gt_workers_destroy(workers);
+            return NULL;
+        }
+        workers->count++;
+    }
+    return workers;
+}
+
+void gt_workers_destroy(struct gt_workers *workers) {
+    if (!workers) return;
+
+    pthread_mutex_lock(&workers->lock);
+    workers->stop = true;
+    pthread_cond_broadcast(&workers->start);
+    pthread_mutex_unlock(&workers->lock);
+
+    for (int i = 0; i < workers->count; i++) pthread_join(workers->threads[i], NULL);
+
+    pthread_cond_destroy(&workers->done);
+    pthread_cond_destroy(&workers->start);
+    pthread_mutex_destroy(&workers->lock);
+    free(workers->threads);
+    free(workers);
+}
+
+// Run fn(arg, 0) .. fn(arg, tasks - 1), returns when all of them are done
+void gt_workers_run(struct gt_workers *workers, int tasks, gt_task_fn fn, void *arg) {
+    pthread_mutex_lock(&workers->lock);
+    workers->fn = fn;
+    workers->arg = arg;
+    workers->tasks = tasks;
+    workers->next = 0;
+    workers->active = workers->count;
+    workers->job++;
+    pthread_cond_broadcast(&workers->start);
+    pthread_mutex_unlock(&workers->lock);
+
+    run_tasks(workers);
+
+    pthread_mutex_lock(&workers->lock);
+    while (workers->active > 0) pthread_cond_wait(&workers->done, &workers->lock);
+    pthread_mutex_unlock(&workers->lock);
+}
@@ -0,0 +1,203 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * cellbench - throughput of the frame diff, in cells per nanosecond
+ *
+ *   cellbench [-n frames]
+ *
+ * For screens from 80x24 to 400x120, and for frames where 1% or 90% of
+ * the cells change, it times:
+ *
+ *   diff   gt_cells_mismatch() walking every row of a frame against the
+ *          previous one, restarting after each mismatch
+ *   hash   gt_cells_hash() over every row
+ *   frame  the whole frame path on a headless context: the frame is
+ *          blitted into a full-screen window, diffed and encoded
+ *
+ * The frame column also gives the bytes the encoder sent per frame.
+ * Build the library with optimization, e.g. CFLAGS += -O2, for numbers
+ * that mean anything.
+ */
+#include "gtlib.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const int sizes[][2] = { { 80, 24 }, { 160, 48 }, { 240, 72 }, { 320, 96 }, { 400, 120 } };
+static const int changed_percent[] = { 1, 90 };
+
+static uint64_t rng_state = 0x2545f4914f6cdd1dull;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 32);
+}
+
+// Frame f + 1 is frame f with `percent` of its cells given a new glyph
+// and style; frames[0] is random text
+static void make_frames(gt_cell_t *frames, int count, size_t cells, int percent) {
+    for (size_t i = 0; i < cells; i++) {
+        gt_cell_t cell = { (char)('a' + rng() % 26), (uint8_t)(rng() % 8), GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+        frames[i] = cell;
+    }
+    for (int f = 1; f < count; f++) {
+        gt_cell_t *frame = &frames[(size_t)f * cells];
+        memcpy(frame, frame - cells, cells * sizeof(gt_cell_t));
+        for (size_t i = 0; i < cells; i++) {
+            if (rng() % 100 >= (uint32_t)percent) continue;
+            frame[i].ch = (char)('a' + (frame[i].ch - 'a' + 1) % 26);
+            frame[i].fg = (uint8_t)((frame[i].fg + 1) % 8);
+        }
+    }
+}
+
+static double bench_diff(const gt_cell_t *frames, int count, int width, int height, int rounds) {
+    size_t cells = (size_t)width * (size_t)height;
+    size_t found = 0;
+    uint64_t start = gt_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int f = 1; f < count; f++) {
+            const gt_cell_t *a = &frames[(size_t)(f - 1) * cells], *b = &frames[(size_t)f * cells];
+            for (int y = 0; y < height; y++) {
+                size_t row = (size_t)y * (size_t)width;
+                for (size_t x = 0; x < (size_t)width; x++) {
+                    x += gt_cells_mismatch(&a[row + x], &b[row + x], (size_t)width - x);
+                    found += x < (size_t)width;
+                }
+            }
+        }
+    }
+    uint64_t ns = gt_now_ns() - start;
+    if (found == 0) fprintf(stderr, "cellbench: no cells changed\n");
+    return (double)cells * (count - 1) * rounds / (double)ns;
+}
+
+static double bench_hash(const gt_cell_t *frames, int count, int width, int height, int rounds) {
+    size_t cells = (size_t)width * (size_t)height;
+    uint64_t sum = 0;
+    uint64_t start = gt_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int f = 0; f < count; f++) {
+            for (int y = 0; y < height; y++) {
+                sum = sum * 31 + gt_cells_hash(&frames[(size_t)f * cells + (size_t)y * (size_t)width], (size_t)width);
+            }
+        }
+    }
+    uint64_t ns = gt_now_ns() - start;
+    if (sum == 0) fprintf(stderr, "cellbench: all hashes summed to 0\n");
+    return (double)cells * count * rounds / (double)ns;
+}
+
+// Returns cells/ns and sets the bytes written per frame
+static double bench_frame(const gt_cell_t *frames, int count, int width, int height, int rounds, double *bytes) {
+    size_t cells = (size_t)width * (size_t)height;
+    int null_fd = open("/dev/null", O_WRONLY);
+    gt_context_t *context = gt_create_headless_context(null_fd, width, height);
+    if (!context) {
+        fprintf(stderr, "cellbench: cannot create the headless backend\n");
+        exit(1);
+    }
+    gt_bind_context(context);
+    gt_init();
+    gt_set_frame_rate(0);
+    gt_window_t *window = gt_create_window(0, 0, width, height, NULL);
+    gt_show_window(window);
+    gt_blit_cells(window, 0, 0, width, height, frames, (size_t)width);
+    gt_request_frame();
+    gt_run_frame();
+
+    gt_stats_t before, after;
+    gt_get_stats(&before);
+    uint64_t start = gt_now_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (int f = 1; f < count; f++) {
+            gt_blit_cells(window, 0, 0, width, height, &frames[(size_t)f * cells], (size_t)width);
+            gt_request_frame();
+            gt_run_frame();
+        }
+        // Back to the first frame outside the clock
+        uint64_t paused = gt_now_ns();
+        gt_blit_cells(window, 0, 0, width, height, frames, (size_t)width);
+        gt_request_frame();
+        gt_run_frame();
+        start += gt_now_ns() - paused;
+    }
+    uint64_t ns = gt_now_ns() - start;
+    gt_get_stats(&after);
+
+    gt_destroy_window(window);
+    gt_cleanup();
+    gt_bind_context(NULL);
+    gt_destroy_context(context);
+    close(null_fd);
+
+    // The resets to frame 0 are counted in bytes_written too
+    uint64_t frames_run = (uint64_t)rounds * (uint64_t)count;
+    *bytes = (double)(after.bytes_written - before.bytes_written) / (double)frames_run;
+    return (double)cells * (count - 1) * rounds / (double)ns;
+}
+
+int main(int argc, char **argv) {
+    int count = 32;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:")) != -1) {
+        switch (opt) {
+            case 'n': count = atoi(optarg) + 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind != argc || count < 2) {
+        fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+        return 2;
+    }
+    gt_cells_init();
+
+    printf("%-8s %8s %12s %12s %12s %12s\n", "size", "changed", "diff c/ns", "hash c/ns", "frame c/ns", "bytes/frame");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int width = sizes[s][0], height = sizes[s][1];
+        size_t cells = (size_t)width * (size_t)height;
+        gt_cell_t *frames = malloc(cells * (size_t)count * sizeof(gt_cell_t));
+        if (!frames) {
+            fprintf(stderr, "cellbench: out of memory\n");
+            return 1;
+        }
+
+        // Enough rounds for about 20M cells per kernel measurement
+        int rounds = (int)(20000000 / (cells * (size_t)count)) + 1;
+        for (size_t c = 0; c < sizeof(changed_percent) / sizeof(changed_percent[0]); c++) {
+            make_frames(frames, count, cells, changed_percent[c]);
+            double diff = bench_diff(frames, count, width, height, rounds);
+            double hash = bench_hash(frames, count, width, height, rounds);
+            double bytes;
+            double frame = bench_frame(frames, count, width, height, rounds / 8 + 1, &bytes);
+
+            char size[16];
+            snprintf(size, sizeof(size), "%dx%d", width, height);
+            printf("%-8s %7d%% %12.2f %12.2f %12.3f %12.0f\n", size, changed_percent[c], diff, hash, frame, bytes);
+        }
+        free(frames);
+    }
+    return 0;
+}
@@ -0,0 +1,298 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * gtreplay - play back a frame recording made with gt_start_recording()
+ *
+ *   gtreplay [-m] [-t] file
+ *
+ *   -m  play as fast as possible instead of with the recorded timing
+ *   -t  draw on this terminal instead of the headless backend
+ *
+ * Every recorded frame is blitted into a full-screen window and sent
+ * through the normal frame path, so with -m the summary printed at the
+ * end is the offline throughput of the encoder for that session.
+ */
+#include "gtlib.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+struct reader {
+    const unsigned char *data;
+    size_t len, off;
+    bool error;
+};
+
+struct replay {
+    gt_cell_t *cells;
+    gt_cell_t *prev;            // the frame before, rows can move from it
+    int width, height;
+    uint64_t frames, keyframes, events, gaps;
+    uint64_t recorded_us;
+};
+
+static int get_byte(struct reader *in) {
+    if (in->off >= in->len) {
+        in->error = true;
+        return 0;
+    }
+    return in->data[in->off++];
+}
+
+static uint64_t get_varint(struct reader *in) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = get_byte(in);
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    in->error = true;
+    return 0;
+}
+
+static void get_cells(struct reader *in, gt_cell_t *cells, size_t count) {
+    size_t i = 0;
+    while (i < count && !in->error) {
+        uint64_t run = get_varint(in);
+        if (run == 0 || run > count - i) {
+            in->error = true;
+            return;
+        }
+        uint8_t fg = (uint8_t)get_byte(in);
+        uint8_t bg = (uint8_t)get_byte(in);
+        uint8_t attr = (uint8_t)get_byte(in);
+        for (uint64_t k = 0; k < run; k++, i++) {
+            cells[i].ch = (char)get_byte(in);
+            cells[i].fg = fg;
+            cells[i].bg = bg;
+            cells[i].attr = attr;
+        }
+    }
+}
+
+static bool read_keyframe(struct reader *in, struct replay *play) {
+    int width = (int)get_varint(in);
+    int height = (int)get_varint(in);
+    if (in->error || width <= 0 || height <= 0 || width > 10000 || height > 10000) return false;
+
+    if (width != play->width || height != play->height) {
+        size_t size = (size_t)width * (size_t)height * sizeof(gt_cell_t);
+        gt_cell_t *cells = realloc(play->cells, size);
+        if (cells) play->cells = cells;
+        gt_cell_t *prev = realloc(play->prev, size);
+        if (prev) play->prev = prev;
+        if (!cells || !prev) return false;
+        play->width = width;
+        play->height = height;
+    }
+    get_cells(in, play->cells, (size_t)width * (size_t)height);
+    play->keyframes++;
+    return !in->error;
+}
+
+static bool read_delta(struct reader *in, struct replay *play) {
+    if (!play->cells) return false;
+
+    size_t width = (size_t)play->width;
+    memcpy(play->prev, play->cells, width * (size_t)play->height * sizeof(gt_cell_t));
+    for (;;) {
+        uint64_t row = get_varint(in);
+        if (in->error) return false;
+        if (row == 0) return true;
+        if (row > (uint64_t)play->height) return false;
+        gt_cell_t *dst = &play->cells[(row - 1) * width];
+
+        // A row that moved, or the changed span of a row
+        uint64_t x = get_varint(in);
+        if (x == 0) {
+            uint64_t from = get_varint(in);
+            if (from >= (uint64_t)play->height) return false;
+            memcpy(dst, &play->prev[from * width], width * sizeof(gt_cell_t));
+            continue;
+        }
+
+        // Checked so that no varint can wrap the sum past the row end
+        uint64_t count = get_varint(in);
+        if (x > width || count > width - (x - 1)) return false;
+        get_cells(in, &dst[x - 1], (size_t)count);
+    }
+}
+
+static unsigned char *read_file(const char *path, size_t *len) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    unsigned char *data = NULL;
+    size_t cap = 0;
+    *len = 0;
+    for (;;) {
+        if (*len == cap) {
+            cap = cap ? cap * 2 : 1 << 20;
+            unsigned char *grown = realloc(data, cap);
+            if (!grown) {
+                free(data);
+                fclose(file);
+                return NULL;
+            }
+            data = grown;
+        }
+        size_t n = fread(data + *len, 1, cap - *len, file);
+        if (n == 0) break;
+        *len += n;
+    }
+    fclose(file);
+    return data;
+}
+
+// Waits out the recorded delay; a 'q' typed on the terminal stops
+static bool wait_for(uint64_t due_ns) {
+    gt_event_t event;
+    for (;;) {
+        uint64_t now = gt_now_ns();
+        int ms = due_ns > now ? (int)((due_ns - now + 999999) / 1000000) : 0;
+        int ret = gt_wait_event(&event, ms);
+        if (ret == 0 && event.type == GT_EVENT_KEY_PRESS && event.data.key == 'q') return false;
+        if (ret != 0 && gt_now_ns() >= due_ns) return true;
+    }
+}
+
+int main(int argc, char **argv) {
+    bool fast = false, terminal = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "mt")) != -1) {
+        switch (opt) {
+            case 'm': fast = true; break;
+            case 't': terminal = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-m] [-t] file\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-m] [-t] file\n", argv[0]);
+        return 2;
+    }
+
+    struct reader in = { NULL, 0, 0, false };
+    unsigned char *data = read_file(argv[optind], &in.len);
+    size_t magic = sizeof(GT_RECORD_MAGIC) - 1;
+    if (!data || in.len < magic || memcmp(data, GT_RECORD_MAGIC, magic) != 0) {
+        fprintf(stderr, "%s: not a GTlib recording\n", argv[optind]);
+        free(data);
+        return 1;
+    }
+    in.data = data;
+    in.off = magic;
+
+    // The first record is the keyframe the headless screen is sized by
+    struct replay play = { NULL, NULL, 0, 0, 0, 0, 0, 0, 0 };
+    if (get_byte(&in) != GT_RECORD_KEYFRAME) {
+        fprintf(stderr, "%s: recording does not start with a keyframe\n", argv[optind]);
+        free(data);
+        return 1;
+    }
+    get_varint(&in);
+    if (!read_keyframe(&in, &play)) {
+        fprintf(stderr, "%s: corrupt keyframe\n", argv[optind]);
+        free(data);
+        return 1;
+    }
+
+    int null_fd = -1;
+    gt_context_t *context = NULL;
+    if (!terminal) {
+        null_fd = open("/dev/null", O_WRONLY);
+        context = gt_create_headless_context(null_fd, play.width, play.height);
+        gt_bind_context(context);
+    }
+    if (!context && !terminal) {
+        fprintf(stderr, "gtreplay: cannot create the headless backend\n");
+        free(data);
+        return 1;
+    }
+    if (gt_init() != 0) {
+        fprintf(stderr, "gtreplay: cannot initialize the terminal\n");
+        free(data);
+        return 1;
+    }
+    gt_set_frame_rate(0);
+
+    gt_window_t *window = gt_create_window(0, 0, play.width, play.height, "gtreplay");
+    gt_show_window(window);
+
+    gt_stats_t stats;
+    uint64_t start_ns = gt_now_ns();
+    uint64_t due_ns = start_ns;
+    bool corrupt = false;
+    bool frame = true;
+
+    for (;;) {
+        if (frame) {
+            gt_blit_cells(window, 0, 0, play.width, play.height, play.cells, (size_t)play.width);
+            gt_refresh_all();
+            if (!wait_for(fast ? 0 : due_ns)) break;
+            play.frames++;
+            frame = false;
+        }
+
+        if (in.off >= in.len) break;
+        int type = get_byte(&in);
+        uint64_t delay_us = get_varint(&in);
+        play.recorded_us += delay_us;
+        due_ns += delay_us * 1000;
+
+        switch (type) {
+            case GT_RECORD_KEYFRAME: frame = read_keyframe(&in, &play); corrupt = !frame; break;
+            case GT_RECORD_DELTA: frame = read_delta(&in, &play); corrupt = !frame; break;
+            case GT_RECORD_EVENT: get_varint(&in); get_varint(&in); play.events++; break;
+            case GT_RECORD_GAP: play.gaps++; break;
+            default: corrupt = true;
+        }
+        if (corrupt || in.error) break;
+    }
+
+    // Let a frame the terminal was too busy for go out before cleaning up
+    if (terminal) wait_for(gt_now_ns() + 100000000ull);
+
+    uint64_t elapsed_ns = gt_now_ns() - start_ns;
+    gt_get_stats(&stats);
+    gt_destroy_window(window);
+    gt_cleanup();
+    if (context) gt_destroy_context(context);
+    if (null_fd >= 0) close(null_fd);
+
+    if (corrupt || in.error) fprintf(stderr, "gtreplay: recording is corrupt at byte %zu\n", in.off);
+    double seconds = (double)elapsed_ns / 1e9;
+    printf("frames      %llu (%llu keyframes, %llu gaps)\n", (unsigned long long)play.frames,
+           (unsigned long long)play.keyframes, (unsigned long long)play.gaps);
+    printf("events      %llu\n", (unsigned long long)play.events);
+    printf("recorded    %.3f s\n", (double)play.recorded_us / 1e6);
+    printf("replayed    %.3f s, %.1f frames/s\n", seconds, seconds > 0 ? (double)play.frames / seconds : 0.0);
+    printf("output      %llu bytes in %llu frames\n", (unsigned long long)stats.bytes_written,
+           (unsigned long long)stats.frames_rendered);
+    printf("frame time  p50 %.3f ms, p99 %.3f ms, max %.3f ms\n", stats.frame_time_p50_ns / 1e6,
+           stats.frame_time_p99_ns / 1e6, stats.frame_time_max_ns / 1e6);
+
+    free(play.cells);
+    free(play.prev);
+    free(data);
+    return corrupt || in.error ? 1 : 0;
+}
@@ -0,0 +1,122 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * gtview - watch a screen shared with gt_start_sharing()
+ *
+ *   gtview socket
+ *
+ * The screen is drawn on this terminal as it changes. Keys are sent to
+ * the application, which reads them only from the viewer in control;
+ * Ctrl-] detaches.
+ */
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define DETACH_KEY 0x1d
+
+static bool write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    struct sockaddr_un addr;
+    if (argc != 2 || strlen(argv[1]) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "usage: %s socket\n", argv[0]);
+        return 2;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, argv[1]);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "gtview: cannot connect to %s: %s\n", argv[1], strerror(errno));
+        return 1;
+    }
+
+    // A write to an application that went away fails instead of killing us
+    signal(SIGPIPE, SIG_IGN);
+
+    struct termios orig, raw;
+    bool tty = tcgetattr(STDIN_FILENO, &orig) == 0;
+    if (tty) {
+        raw = orig;
+        raw.c_iflag &= ~(IXON | ICRNL | INLCR | IGNCR);
+        raw.c_lflag &= ~(ECHO | ICANON | ISIG | IEXTEN);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+    }
+
+    char buf[4096];
+    bool input = true;
+    const char *reason = "detached";
+    for (;;) {
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(fd, &readfds);
+        if (input) FD_SET(STDIN_FILENO, &readfds);
+        if (select(fd + 1, &readfds, NULL, NULL, NULL) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (FD_ISSET(fd, &readfds)) {
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                reason = "the application stopped sharing";
+                break;
+            }
+            if (!write_all(STDOUT_FILENO, buf, (size_t)n)) break;
+        }
+
+        if (input && FD_ISSET(STDIN_FILENO, &readfds)) {
+            ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+            if (n <= 0) {
+                input = false;
+                continue;
+            }
+            char *detach = memchr(buf, DETACH_KEY, (size_t)n);
+            size_t len = detach ? (size_t)(detach - buf) : (size_t)n;
+            if (len > 0 && !write_all(fd, buf, len)) break;
+            if (detach) break;
+        }
+    }
+
+    close(fd);
+    if (tty) tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig);
+    printf("\033[0m\033[?25h\033[?2026l\n[%s]\n", reason);
+    return 0;
+}
@@ -0,0 +1,179 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * wirebench - size and speed of the cell span wire format
+ *
+ *   wirebench [-r rounds]
+ *
+ * Encodes full windows of typical content with gt_wire_encode_cells()
+ * and decodes them again with gt_wire_decode_cells(), checking that the
+ * cells come back unchanged. For each kind of content and window size it
+ * prints the bytes per frame against the raw cells, and the encode and
+ * decode time per cell. Build the library with optimization, e.g.
+ * CFLAGS += -O2, for timings that mean anything.
+ */
+#include "gtlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const int sizes[][2] = { { 80, 24 }, { 200, 60 }, { 400, 120 } };
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ull;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 32);
+}
+
+static void fill(gt_cell_t *cells, int width, int x, int y, int w, int h, char ch, int fg, int bg, int attr) {
+    gt_cell_t cell = { ch, (uint8_t)fg, (uint8_t)bg, (uint8_t)attr };
+    for (int row = y; row < y + h; row++) {
+        for (int col = x; col < x + w; col++) cells[(size_t)row * (size_t)width + (size_t)col] = cell;
+    }
+}
+
+static void text(gt_cell_t *cells, int width, int x, int y, int len, int fg, int bg) {
+    for (int i = 0; i < len && x + i < width; i++) {
+        gt_cell_t *cell = &cells[(size_t)y * (size_t)width + (size_t)(x + i)];
+        cell->ch = rng() % 6 == 0 ? ' ' : (char)('a' + rng() % 26);
+        cell->fg = (uint8_t)fg;
+        cell->bg = (uint8_t)bg;
+        cell->attr = GT_ATTR_NORMAL;
+    }
+}
+
+static void blank(gt_cell_t *cells, int width, int height) {
+    fill(cells, width, 0, 0, width, height, ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+}
+
+// A bordered window with a title bar, two panels, labels and a button row
+static void form(gt_cell_t *cells, int width, int height) {
+    blank(cells, width, height);
+    fill(cells, width, 0, 0, width, 1, '-', GT_COLOR_WHITE, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    fill(cells, width, 0, height - 1, width, 1, '-', GT_COLOR_WHITE, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    fill(cells, width, 0, 1, 1, height - 2, '|', GT_COLOR_WHITE, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    fill(cells, width, width - 1, 1, 1, height - 2, '|', GT_COLOR_WHITE, GT_COLOR_DEFAULT, GT_ATTR_NORMAL);
+    text(cells, width, 2, 0, 12, GT_COLOR_YELLOW, GT_COLOR_DEFAULT);
+    fill(cells, width, 2, 2, width / 2 - 3, height - 6, ' ', GT_COLOR_WHITE, GT_COLOR_BLUE, GT_ATTR_NORMAL);
+    fill(cells, width, width / 2 + 1, 2, width / 2 - 3, height - 6, ' ', GT_COLOR_BLACK, GT_COLOR_WHITE, GT_ATTR_NORMAL);
+    for (int y = 3; y < height - 5; y += 2) {
+        text(cells, width, 4, y, width / 4, GT_COLOR_WHITE, GT_COLOR_BLUE);
+        text(cells, width, width / 2 + 3, y, width / 5, GT_COLOR_BLACK, GT_COLOR_WHITE);
+    }
+    for (int x = 4; x + 10 < width - 1; x += 14) {
+        fill(cells, width, x, height - 3, 10, 1, ' ', GT_COLOR_YELLOW, GT_COLOR_BLUE, GT_ATTR_BOLD);
+        text(cells, width, x + 2, height - 3, 6, GT_COLOR_YELLOW, GT_COLOR_BLUE);
+    }
+}
+
+// A log or editor: ragged lines of text, some highlighted
+static void log_view(gt_cell_t *cells, int width, int height) {
+    blank(cells, width, height);
+    for (int y = 0; y < height; y++) {
+        int fg = rng() % 8 == 0 ? GT_COLOR_RED : GT_COLOR_DEFAULT;
+        text(cells, width, 0, y, (int)(rng() % (uint32_t)width), fg, GT_COLOR_DEFAULT);
+    }
+}
+
+// Worst case: every cell a random glyph and style
+static void noise(gt_cell_t *cells, int width, int height) {
+    for (size_t i = 0; i < (size_t)width * (size_t)height; i++) {
+        gt_cell_t cell = { (char)(33 + rng() % 94), (uint8_t)(rng() % 9), (uint8_t)(rng() % 9), (uint8_t)(rng() % 4) };
+        cells[i] = cell;
+    }
+}
+
+static const struct {
+    const char *name;
+    void (*draw)(gt_cell_t *cells, int width, int height);
+} contents[] = {
+    { "blank", blank },
+    { "form", form },
+    { "log", log_view },
+    { "noise", noise },
+};
+
+int main(int argc, char **argv) {
+    int rounds = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "r:")) != -1) {
+        switch (opt) {
+            case 'r': rounds = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-r rounds]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind != argc || rounds < 0) {
+        fprintf(stderr, "usage: %s [-r rounds]\n", argv[0]);
+        return 2;
+    }
+
+    printf("%-6s %-8s %10s %10s %7s %12s %12s\n", "what", "size", "raw", "bytes", "ratio", "enc ns/cell", "dec ns/cell");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int width = sizes[s][0], height = sizes[s][1];
+        size_t count = (size_t)width * (size_t)height;
+        gt_cell_t *cells = malloc(count * sizeof(gt_cell_t));
+        gt_cell_t *decoded = malloc(count * sizeof(gt_cell_t));
+        uint8_t *wire = malloc(gt_wire_cells_bound(count));
+        if (!cells || !decoded || !wire) {
+            fprintf(stderr, "wirebench: out of memory\n");
+            return 1;
+        }
+
+        // About 20M cells per measurement unless given
+        int n = rounds > 0 ? rounds : (int)(20000000 / count) + 1;
+        for (size_t c = 0; c < sizeof(contents) / sizeof(contents[0]); c++) {
+            contents[c].draw(cells, width, height);
+
+            size_t len = 0;
+            uint64_t start = gt_now_ns();
+            for (int r = 0; r < n; r++) len = gt_wire_encode_cells(cells, (size_t)width, 0, 0, width, height, wire);
+            uint64_t encode_ns = gt_now_ns() - start;
+
+            struct gt_wire_span span;
+            int ret = 0;
+            start = gt_now_ns();
+            for (int r = 0; r < n && ret == 0; r++) ret = gt_wire_decode_cells(wire, len, &span, decoded, count);
+            uint64_t decode_ns = gt_now_ns() - start;
+
+            if (ret != 0 || span.width != width || span.height != height ||
+                memcmp(cells, decoded, count * sizeof(gt_cell_t)) != 0) {
+                fprintf(stderr, "wirebench: %s %dx%d does not decode to what was encoded\n",
+                        contents[c].name, width, height);
+                return 1;
+            }
+
+            char size[16];
+            snprintf(size, sizeof(size), "%dx%d", width, height);
+            size_t raw = count * sizeof(gt_cell_t);
+            printf("%-6s %-8s %10zu %10zu %6.1f%% %12.3f %12.3f\n", contents[c].name, size, raw, len,
+                   100.0 * (double)len / (double)raw,
+                   (double)encode_ns / ((double)count * n), (double)decode_ns / ((double)count * n));
+        }
+        free(cells);
+        free(decoded);
+        free(wire);
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "eclib_shim.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/*
+ * Messages are datagrams: the ipc_message_t header, then the payload.
+ * A datagram the kernel queued is delivered, so the shim keeps no
+ * receipts and reports every message it sent as taken. A full receive
+ * queue is ECLIB_IPC_MSG_QUEUE_FULL, as with a congested service.
+ */
+
+// ipc_get_msg_state() value of a message the receiver has
+#define SHIM_STATE_TAKEN 1
+
+static int sock_fd = -1;
+static pid_t sock_pid;              // process the socket belongs to, forks open their own
+static uint64_t next_seq = 1;
+
+static const char *ipc_dir(void) {
+    const char *dir = getenv("ECLIB_IPC_DIR");
+    return dir && *dir ? dir : "/tmp/eclib-ipc";
+}
+
+static bool endpoint_addr(struct sockaddr_un *addr, uint32_t pid) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    int len = snprintf(addr->sun_path, sizeof(addr->sun_path), "%s/%u.sock", ipc_dir(), pid);
+    return len > 0 && (size_t)len < sizeof(addr->sun_path);
+}
+
+static void close_endpoint(void) {
+    struct sockaddr_un addr;
+    if (sock_fd < 0 || sock_pid != getpid()) return;
+    if (endpoint_addr(&addr, (uint32_t)sock_pid)) unlink(addr.sun_path);
+}
+
+int eclib_shim_fd(void) {
+    if (sock_fd >= 0 && sock_pid == getpid()) return sock_fd;
+    if (sock_fd >= 0) close(sock_fd);
+    sock_fd = -1;
+
+    struct sockaddr_un addr;
+    pid_t pid = getpid();
+    mkdir(ipc_dir(), 0700);
+    if (!endpoint_addr(&addr, (uint32_t)pid)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0) return -1;
+    unlink(addr.sun_path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    static bool registered;
+    if (!registered) atexit(close_endpoint);
+    registered = true;
+    sock_fd = fd;
+    sock_pid = pid;
+    return fd;
+}
+
+eclib_err_t ipc_send_msg(uint32_t pid, uint16_t msg_id, const void *data, size_t data_len,
+                         int need_feedback, uint64_t *msg_seq) {
+    (void)need_feedback;
+    if (data_len > ECLIB_SHIM_PAYLOAD_MAX) return ECLIB_IPC_BUFFER_OVERFLOW;
+
+    int fd = eclib_shim_fd();
+    struct sockaddr_un addr;
+    if (fd < 0) return ECLIB_IPC_SERVICE_UNAVAIL;
+    if (!endpoint_addr(&addr, pid)) return ECLIB_IPC_INVALID_ENDPOINT;
+
+    ipc_message_t header = { msg_id, (uint32_t)getpid(), pid, (uint32_t)data_len };
+    struct iovec iov[2] = {
+        { &header, sizeof(header) },
+        { (void *)data, data_len }
+    };
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &addr;
+    msg.msg_namelen = sizeof(addr);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
+    while (sendmsg(fd, &msg, 0) < 0) {
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) return ECLIB_IPC_MSG_QUEUE_FULL;
+        if (errno == ENOENT || errno == ECONNREFUSED) return ECLIB_IPC_CONNECTION_LOST;
+        if (errno == EMSGSIZE) return ECLIB_IPC_BUFFER_OVERFLOW;
+        return ECLIB_IPC_MESSAGES_UNKNOWN;
+    }
+    if (msg_seq) *msg_seq = next_seq++;
+    return ECLIB_OK;
+}
+
+eclib_err_t ipc_get_msg_state(uint64_t msg_seq, uint8_t *msg_state) {
+    if (msg_seq == 0 || msg_seq >= next_seq) return ECLIB_IPC_MSG_NOT_FOUND;
+    *msg_state = SHIM_STATE_TAKEN;
+    return ECLIB_OK;
+}
+
+eclib_err_t eclib_shim_recv(ipc_message_t *msg, size_t size) {
+    int fd = eclib_shim_fd();
+    if (fd < 0) return ECLIB_IPC_SERVICE_UNAVAIL;
+    if (size < sizeof(ipc_message_t)) return ECLIB_IPC_BUFFER_OVERFLOW;
+
+    for (;;) {
+        ssize_t n = recv(fd, msg, size, MSG_TRUNC);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return ECLIB_IPC_MSG_NOT_FOUND;
+        if ((size_t)n > size) return ECLIB_IPC_BUFFER_OVERFLOW;
+        if ((size_t)n < sizeof(ipc_message_t) || msg->payload_size != (size_t)n - sizeof(ipc_message_t)) {
+            return ECLIB_IPC_INVALID_MSG_FORMAT;
+        }
+        return ECLIB_OK;
+    }
+}
+
+static bool service_path(char *path, size_t size, const char *service_name) {
+    if (!service_name || !*service_name || strchr(service_name, '/')) return false;
+    int len = snprintf(path, size, "%s/%s.service", ipc_dir(), service_name);
+    return len > 0 && (size_t)len < size;
+}
+
+uint32_t eclib_service_lookup(const char *service_name) {
+    char path[256];
+    if (!service_path(path, sizeof(path), service_name)) return 0;
+
+    FILE *file = fopen(path, "r");
+    if (!file) return 0;
+    unsigned pid = 0;
+    if (fscanf(file, "%u", &pid) != 1) pid = 0;
+    fclose(file);
+
+    // A service that exited without unregistering is not there
+    if (pid == 0 || (kill((pid_t)pid, 0) != 0 && errno == ESRCH)) return 0;
+    return pid;
+}
+
+eclib_err_t eclib_service_register(const char *service_name) {
+    char path[256], tmp[272];
+    if (!service_path(path, sizeof(path), service_name)) return ECLIB_IPC_INVALID_ENDPOINT;
+    if (eclib_shim_fd() < 0) return ECLIB_IPC_SERVICE_UNAVAIL;
+
+    // Written aside and renamed, so a lookup never reads half a pid
+    snprintf(tmp, sizeof(tmp), "%s.%u", path, (unsigned)getpid());
+    FILE *file = fopen(tmp, "w");
+    if (!file) return ECLIB_IPC_PERMISSION_DENIED;
+    fprintf(file, "%u\n", (unsigned)getpid());
+    if (fclose(file) != 0 || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return ECLIB_IPC_PERMISSION_DENIED;
+    }
+    return ECLIB_OK;
+}
+
+eclib_err_t eclib_service_unregister(const char *service_name) {
+    char path[256];
+    if (!service_path(path, sizeof(path), service_name)) return ECLIB_IPC_INVALID_ENDPOINT;
+    if (eclib_service_lookup(service_name) != (uint32_t)getpid()) return ECLIB_IPC_PERMISSION_DENIED;
+    unlink(path);
+    return ECLIB_OK;
+}
+
+uint32_t eclib_getpid(void) {
+    return (uint32_t)getpid();
+}
@@ -0,0 +1,42 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#ifndef ECLIB_SHIM_H
+#define ECLIB_SHIM_H
+
+#include <ipc_message.h>
+#include <service.h>
+
+/*
+ * The part of ECLib GTlib and the reference WM service use, on Linux.
+ * Every process gets a datagram socket in $ECLIB_IPC_DIR (default
+ * /tmp/eclib-ipc) named after its pid, and a registered service is a
+ * file there holding the pid. ECLib has no receive call yet, so the
+ * shim adds the two below.
+ */
+
+// Largest payload ipc_send_msg() accepts
+#define ECLIB_SHIM_PAYLOAD_MAX (64 * 1024)
+
+// Socket to wait on for messages, -1 if it cannot be opened
+int eclib_shim_fd(void);
+
+// Take the next message without waiting. msg has room for size bytes,
+// header included. ECLIB_IPC_MSG_NOT_FOUND when none is queued
+eclib_err_t eclib_shim_recv(ipc_message_t *msg, size_t size);
+
+#endif
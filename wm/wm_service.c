@@ -0,0 +1,570 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * wm_service - reference window_manager service
+ *
+ *   wm_service [-n] [-t seconds]
+ *
+ *   -n  composite on the headless backend (80x24) instead of this terminal
+ *   -t  exit after the given number of seconds
+ *
+ * Registers as "window_manager" and composites the windows of every
+ * GTlib client into one screen, drawn with GTlib itself. A client draws
+ * into the back buffer of its window; GT_IPC_REFRESH_WINDOW shows what
+ * changed, and only the screen cells it covers are composited again.
+ * Frames are paced by the GTlib frame scheduler, however many clients
+ * refresh. Keys go to the focused window, Ctrl-N raises and focuses the
+ * bottom one, Ctrl-C quits.
+ */
+#include "gtlib.h"
+#include "eclib_shim.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define FOCUS_NEXT_KEY 0x0e         // Ctrl-N
+#define RECV_BATCH 1024             // messages taken before input is read again
+#define WINDOW_SIZE_MAX 1024
+#define TITLE_MAX 48
+#define MESSAGE_SIZE (sizeof(ipc_message_t) + ECLIB_SHIM_PAYLOAD_MAX)
+
+struct client_window {
+    struct client_window *next;     // the window above
+    uint32_t pid, id;
+    int x, y, width, height;
+    char title[TITLE_MAX];
+    gt_cell_t *back;                // drawn by the client
+    gt_cell_t *front;               // as of the last refresh
+    int dirty_x0, dirty_y0, dirty_x1, dirty_y1;     // back cells not shown yet
+};
+
+struct wm {
+    struct client_window *windows;  // bottom first
+    struct client_window *focus;
+    gt_window_t *desktop;
+    int width, height;
+    int *damage_x0, *damage_x1;     // screen cells to composite, per row
+    gt_cell_t *row;
+    gt_cell_t *span;                // decoded GT_IPC_DRAW_CELLS
+    size_t span_cap;
+    uint64_t messages[GT_IPC_DRAW_CELLS + 1];
+    uint64_t bytes, rejected, composited, keys_routed, clients_reaped;
+};
+
+static const gt_cell_t blank = { ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+
+static volatile sig_atomic_t quit;
+
+static void on_signal(int sig) {
+    (void)sig;
+    quit = 1;
+}
+
+// Composite the screen rectangle again on the next pass
+static void damage(struct wm *wm, int x, int y, int width, int height) {
+    if (x < 0) { width += x; x = 0; }
+    if (y < 0) { height += y; y = 0; }
+    if (x + width > wm->width) width = wm->width - x;
+    if (y + height > wm->height) height = wm->height - y;
+    if (width <= 0 || height <= 0) return;
+
+    for (int row = y; row < y + height; row++) {
+        if (wm->damage_x0[row] >= wm->damage_x1[row]) {
+            wm->damage_x0[row] = x;
+            wm->damage_x1[row] = x + width;
+            continue;
+        }
+        if (x < wm->damage_x0[row]) wm->damage_x0[row] = x;
+        if (x + width > wm->damage_x1[row]) wm->damage_x1[row] = x + width;
+    }
+}
+
+static void damage_status(struct wm *wm) {
+    damage(wm, 0, wm->height - 1, wm->width, 1);
+}
+
+// Clip a rectangle to the window; false if nothing is left
+static bool clip(const struct client_window *win, int *x, int *y, int *width, int *height) {
+    if (*x < 0) { *width += *x; *x = 0; }
+    if (*y < 0) { *height += *y; *y = 0; }
+    if (*x + *width > win->width) *width = win->width - *x;
+    if (*y + *height > win->height) *height = win->height - *y;
+    return *width > 0 && *height > 0;
+}
+
+static void mark_dirty(struct client_window *win, int x, int y, int width, int height) {
+    if (win->dirty_x0 >= win->dirty_x1) {
+        win->dirty_x0 = x;
+        win->dirty_y0 = y;
+        win->dirty_x1 = x + width;
+        win->dirty_y1 = y + height;
+        return;
+    }
+    if (x < win->dirty_x0) win->dirty_x0 = x;
+    if (y < win->dirty_y0) win->dirty_y0 = y;
+    if (x + width > win->dirty_x1) win->dirty_x1 = x + width;
+    if (y + height > win->dirty_y1) win->dirty_y1 = y + height;
+}
+
+static void fill(struct client_window *win, int x, int y, int width, int height, gt_cell_t cell) {
+    if (!clip(win, &x, &y, &width, &height)) return;
+    for (int row = y; row < y + height; row++) {
+        gt_cell_t *dst = &win->back[(size_t)row * (size_t)win->width + (size_t)x];
+        for (int col = 0; col < width; col++) dst[col] = cell;
+    }
+    mark_dirty(win, x, y, width, height);
+}
+
+static struct client_window *find_window(struct wm *wm, uint32_t pid, uint32_t id) {
+    for (struct client_window *win = wm->windows; win; win = win->next) {
+        if (win->pid == pid && win->id == id) return win;
+    }
+    return NULL;
+}
+
+static void unlink_window(struct wm *wm, struct client_window *win) {
+    struct client_window **link = &wm->windows;
+    while (*link != win) link = &(*link)->next;
+    *link = win->next;
+    win->next = NULL;
+}
+
+static void push_top(struct wm *wm, struct client_window *win) {
+    struct client_window **link = &wm->windows;
+    while (*link) link = &(*link)->next;
+    *link = win;
+    win->next = NULL;
+}
+
+static void raise_window(struct wm *wm, struct client_window *win) {
+    unlink_window(wm, win);
+    push_top(wm, win);
+    wm->focus = win;
+    damage(wm, win->x, win->y, win->width, win->height);
+    damage_status(wm);
+}
+
+static void destroy_window(struct wm *wm, struct client_window *win) {
+    unlink_window(wm, win);
+    damage(wm, win->x, win->y, win->width, win->height);
+    damage_status(wm);
+
+    // Focus passes to the window on top
+    if (wm->focus == win) {
+        wm->focus = wm->windows;
+        while (wm->focus && wm->focus->next) wm->focus = wm->focus->next;
+    }
+    free(win->back);
+    free(win->front);
+    free(win);
+}
+
+static bool create_window(struct wm *wm, uint32_t pid, uint32_t id, const uint8_t *data, size_t len) {
+    struct gt_ipc_geometry geometry;
+    if (len < sizeof(geometry)) return false;
+    memcpy(&geometry, data, sizeof(geometry));
+    if (geometry.width <= 0 || geometry.height <= 0 ||
+        geometry.width > WINDOW_SIZE_MAX || geometry.height > WINDOW_SIZE_MAX) return false;
+
+    // Creating a window again replaces it, at its new size
+    struct client_window *old = find_window(wm, pid, id);
+    if (old) destroy_window(wm, old);
+
+    size_t count = (size_t)geometry.width * (size_t)geometry.height;
+    struct client_window *win = calloc(1, sizeof(*win));
+    if (win) {
+        win->back = malloc(count * sizeof(gt_cell_t));
+        win->front = malloc(count * sizeof(gt_cell_t));
+    }
+    if (!win || !win->back || !win->front) {
+        if (win) {
+            free(win->back);
+            free(win->front);
+        }
+        free(win);
+        return false;
+    }
+
+    win->pid = pid;
+    win->id = id;
+    win->x = geometry.x;
+    win->y = geometry.y;
+    win->width = geometry.width;
+    win->height = geometry.height;
+    size_t title_len = len - sizeof(geometry);
+    if (title_len >= TITLE_MAX) title_len = TITLE_MAX - 1;
+    memcpy(win->title, data + sizeof(geometry), title_len);
+    win->title[title_len] = '\0';
+    for (size_t i = 0; i < count; i++) win->back[i] = win->front[i] = blank;
+
+    push_top(wm, win);
+    raise_window(wm, win);
+    return true;
+}
+
+// Show what the client drew since its last refresh
+static void refresh_window(struct wm *wm, struct client_window *win) {
+    if (win->dirty_x0 >= win->dirty_x1) return;
+
+    size_t width = (size_t)(win->dirty_x1 - win->dirty_x0);
+    for (int row = win->dirty_y0; row < win->dirty_y1; row++) {
+        size_t off = (size_t)row * (size_t)win->width + (size_t)win->dirty_x0;
+        memcpy(&win->front[off], &win->back[off], width * sizeof(gt_cell_t));
+    }
+    damage(wm, win->x + win->dirty_x0, win->y + win->dirty_y0,
+           win->dirty_x1 - win->dirty_x0, win->dirty_y1 - win->dirty_y0);
+    win->dirty_x0 = win->dirty_x1 = 0;
+}
+
+static void draw_border(struct client_window *win, gt_cell_t cell) {
+    cell.ch = '-';
+    fill(win, 0, 0, win->width, 1, cell);
+    fill(win, 0, win->height - 1, win->width, 1, cell);
+    cell.ch = '|';
+    fill(win, 0, 0, 1, win->height, cell);
+    fill(win, win->width - 1, 0, 1, win->height, cell);
+    cell.ch = '+';
+    fill(win, 0, 0, 1, 1, cell);
+    fill(win, win->width - 1, 0, 1, 1, cell);
+    fill(win, 0, win->height - 1, 1, 1, cell);
+    fill(win, win->width - 1, win->height - 1, 1, 1, cell);
+}
+
+static bool draw_cells(struct wm *wm, struct client_window *win, const uint8_t *data, size_t len) {
+    struct gt_wire_span span;
+    if (gt_wire_decode_cells(data, len, &span, NULL, 0) != 0) return false;
+
+    size_t count = (size_t)span.width * (size_t)span.height;
+    if (count > wm->span_cap) {
+        gt_cell_t *cells = realloc(wm->span, count * sizeof(gt_cell_t));
+        if (!cells) return false;
+        wm->span = cells;
+        wm->span_cap = count;
+    }
+    if (gt_wire_decode_cells(data, len, &span, wm->span, wm->span_cap) != 0) return false;
+
+    int x = span.x, y = span.y, width = span.width, height = span.height;
+    if (!clip(win, &x, &y, &width, &height)) return true;
+    for (int row = 0; row < height; row++) {
+        memcpy(&win->back[(size_t)(y + row) * (size_t)win->width + (size_t)x],
+               &wm->span[(size_t)(y - span.y + row) * (size_t)span.width + (size_t)(x - span.x)],
+               (size_t)width * sizeof(gt_cell_t));
+    }
+    mark_dirty(win, x, y, width, height);
+    return true;
+}
+
+// Apply one client message; false if it was malformed or not for a window
+static bool handle_message(struct wm *wm, const ipc_message_t *msg) {
+    uint32_t type, id;
+    if (msg->payload_size < sizeof(type) + sizeof(id)) return false;
+    memcpy(&type, msg->payload, sizeof(type));
+    memcpy(&id, msg->payload + sizeof(type), sizeof(id));
+    const uint8_t *data = msg->payload + sizeof(type) + sizeof(id);
+    size_t len = msg->payload_size - sizeof(type) - sizeof(id);
+    if (type > GT_IPC_DRAW_CELLS) return false;
+    wm->messages[type]++;
+
+    if (type == GT_IPC_CREATE_WINDOW) return create_window(wm, msg->sender_pid, id, data, len);
+    struct client_window *win = find_window(wm, msg->sender_pid, id);
+    if (!win) return false;
+
+    struct gt_ipc_draw draw;
+    gt_cell_t cell = blank;
+    switch (type) {
+        case GT_IPC_DESTROY_WINDOW:
+            destroy_window(wm, win);
+            return true;
+        case GT_IPC_DRAW_CHAR:
+            if (len < sizeof(draw)) return false;
+            memcpy(&draw, data, sizeof(draw));
+            cell = (gt_cell_t){ draw.ch, draw.fg, draw.bg, draw.attr };
+            fill(win, draw.x, draw.y, 1, 1, cell);
+            return true;
+        case GT_IPC_DRAW_STRING:
+            if (len < offsetof(struct gt_ipc_draw, ch)) return false;
+            memcpy(&draw, data, offsetof(struct gt_ipc_draw, ch));
+            cell = (gt_cell_t){ ' ', draw.fg, draw.bg, draw.attr };
+            for (size_t i = offsetof(struct gt_ipc_draw, ch); i < len && data[i]; i++) {
+                cell.ch = (char)data[i];
+                fill(win, draw.x++, draw.y, 1, 1, cell);
+            }
+            return true;
+        case GT_IPC_DRAW_BORDER:
+            if (len < 3) return false;
+            cell = (gt_cell_t){ ' ', data[0], data[1], data[2] };
+            draw_border(win, cell);
+            return true;
+        case GT_IPC_CLEAR_WINDOW:
+            fill(win, 0, 0, win->width, win->height, blank);
+            return true;
+        case GT_IPC_REFRESH_WINDOW:
+            refresh_window(wm, win);
+            return true;
+        case GT_IPC_DRAW_CELLS:
+            return draw_cells(wm, win, data, len);
+        default:
+            // Events go from the WM service to clients, not back
+            return false;
+    }
+}
+
+static void status_line(struct wm *wm, gt_cell_t *row, int x0, int x1) {
+    char text[256];
+    int windows = 0;
+    for (struct client_window *win = wm->windows; win; win = win->next) windows++;
+    if (wm->focus) {
+        snprintf(text, sizeof(text), " window_manager  %d windows  focus: %s [%u]  Ctrl-N next  Ctrl-C quit",
+                 windows, wm->focus->title, (unsigned)wm->focus->pid);
+    } else {
+        snprintf(text, sizeof(text), " window_manager  %d windows  Ctrl-C quit", windows);
+    }
+
+    size_t len = strlen(text);
+    for (int x = x0; x < x1; x++) {
+        row[x - x0] = (gt_cell_t){ (size_t)x < len ? text[x] : ' ', GT_COLOR_BLACK, GT_COLOR_CYAN, GT_ATTR_NORMAL };
+    }
+}
+
+// Composite the damaged cells, bottom window first, onto the desktop
+static void composite(struct wm *wm) {
+    bool changed = false;
+    for (int y = 0; y < wm->height; y++) {
+        int x0 = wm->damage_x0[y], x1 = wm->damage_x1[y];
+        if (x0 >= x1) continue;
+        wm->damage_x0[y] = wm->damage_x1[y] = 0;
+
+        if (y == wm->height - 1) {
+            status_line(wm, wm->row, x0, x1);
+        } else {
+            for (int x = x0; x < x1; x++) wm->row[x - x0] = blank;
+            for (struct client_window *win = wm->windows; win; win = win->next) {
+                if (y < win->y || y >= win->y + win->height) continue;
+                int from = x0 > win->x ? x0 : win->x;
+                int to = x1 < win->x + win->width ? x1 : win->x + win->width;
+                if (from >= to) continue;
+                memcpy(&wm->row[from - x0], &win->front[(size_t)(y - win->y) * (size_t)win->width + (size_t)(from - win->x)],
+                       (size_t)(to - from) * sizeof(gt_cell_t));
+            }
+        }
+        gt_blit_cells(wm->desktop, x0, y, x1 - x0, 1, wm->row, (size_t)(x1 - x0));
+        wm->composited += (uint64_t)(x1 - x0);
+        changed = true;
+    }
+    if (changed) gt_request_frame();
+}
+
+static void send_event(struct client_window *win, gt_ipc_msg_type_t type, const void *data, size_t len) {
+    uint8_t payload[sizeof(uint32_t) * 2 + sizeof(struct gt_ipc_mouse)];
+    uint32_t type_id = (uint32_t)type;
+    memcpy(payload, &type_id, sizeof(uint32_t));
+    memcpy(payload + sizeof(uint32_t), &win->id, sizeof(uint32_t));
+    memcpy(payload + sizeof(uint32_t) * 2, data, len);
+
+    // A client too busy to take its input loses it, as a terminal would
+    ipc_send_msg(win->pid, (uint16_t)type, payload, sizeof(uint32_t) * 2 + len, 0, NULL);
+}
+
+static void route_event(struct wm *wm, const gt_event_t *event) {
+    if (event->type == GT_EVENT_KEY_PRESS) {
+        if (event->data.key == FOCUS_NEXT_KEY) {
+            if (wm->windows && wm->windows->next) raise_window(wm, wm->windows);
+            return;
+        }
+        if (!wm->focus) return;
+        int32_t key = (int32_t)event->data.key;
+        send_event(wm->focus, GT_IPC_EVENT_KEY, &key, sizeof(key));
+        wm->keys_routed++;
+    } else if (event->type == GT_EVENT_MOUSE) {
+        // To the window under the pointer, which a click raises
+        const gt_mouse_event_t *mouse = &event->data.mouse;
+        struct client_window *hit = NULL;
+        for (struct client_window *win = wm->windows; win; win = win->next) {
+            if (mouse->x >= win->x && mouse->x < win->x + win->width &&
+                mouse->y >= win->y && mouse->y < win->y + win->height) hit = win;
+        }
+        if (!hit) return;
+        if (mouse->type != GT_MOUSE_MOVE && hit != wm->focus) raise_window(wm, hit);
+        struct gt_ipc_mouse data = { mouse->type, mouse->x - hit->x, mouse->y - hit->y, mouse->button };
+        send_event(hit, GT_IPC_EVENT_MOUSE, &data, sizeof(data));
+    }
+}
+
+// Drop the windows of clients that exited without destroying them
+static void reap_clients(struct wm *wm) {
+    struct client_window *win = wm->windows;
+    while (win) {
+        if (kill((pid_t)win->pid, 0) == 0 || errno != ESRCH) {
+            win = win->next;
+            continue;
+        }
+
+        uint32_t pid = win->pid;
+        struct client_window *it = wm->windows;
+        while (it) {
+            struct client_window *next = it->next;
+            if (it->pid == pid) destroy_window(wm, it);
+            it = next;
+        }
+        wm->clients_reaped++;
+        win = wm->windows;
+    }
+}
+
+int main(int argc, char **argv) {
+    bool headless = false;
+    double seconds = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0) {
+            headless = true;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [-n] [-t seconds]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    gt_context_t *context = NULL;
+    if (headless) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        context = gt_create_headless_context(null_fd, 80, 24);
+        gt_bind_context(context);
+    }
+    if (gt_init() != 0) {
+        fprintf(stderr, "wm_service: cannot initialize the terminal\n");
+        return 1;
+    }
+
+    int shim_fd = eclib_shim_fd();
+    if (shim_fd < 0 || eclib_service_register("window_manager") != ECLIB_OK) {
+        gt_cleanup();
+        fprintf(stderr, "wm_service: cannot register the window_manager service\n");
+        return 1;
+    }
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    struct wm wm;
+    memset(&wm, 0, sizeof(wm));
+    wm.width = gt_screen_width();
+    wm.height = gt_screen_height();
+    wm.desktop = gt_create_window(0, 0, wm.width, wm.height, "window_manager");
+    gt_show_window(wm.desktop);
+    wm.damage_x0 = calloc((size_t)wm.height, sizeof(int));
+    wm.damage_x1 = calloc((size_t)wm.height, sizeof(int));
+    wm.row = malloc((size_t)wm.width * sizeof(gt_cell_t));
+    ipc_message_t *msg = malloc(MESSAGE_SIZE);
+    if (!wm.damage_x0 || !wm.damage_x1 || !wm.row || !msg) {
+        gt_cleanup();
+        fprintf(stderr, "wm_service: out of memory\n");
+        return 1;
+    }
+    damage(&wm, 0, 0, wm.width, wm.height);
+
+    uint64_t start_ns = gt_now_ns();
+    uint64_t end_ns = seconds > 0 ? start_ns + (uint64_t)(seconds * 1e9) : 0;
+    uint64_t reap_ns = start_ns;
+    int in_fd = gt_ctx()->in_fd;
+    int out_fd = gt_output_fd();
+
+    while (!quit) {
+        uint64_t now = gt_now_ns();
+        if (end_ns && now >= end_ns) break;
+        if (now - reap_ns >= 1000000000ull) {
+            reap_clients(&wm);
+            reap_ns = now;
+        }
+        composite(&wm);
+
+        int wait = gt_frame_wait_ms();
+        if (wait < 0 || wait > 1000) wait = 1000;
+        if (end_ns && (end_ns - now) / 1000000 < (uint64_t)wait) wait = (int)((end_ns - now) / 1000000);
+        fd_set readfds, writefds;
+        FD_ZERO(&readfds);
+        FD_ZERO(&writefds);
+        FD_SET(shim_fd, &readfds);
+        int max_fd = shim_fd;
+        if (in_fd >= 0) {
+            FD_SET(in_fd, &readfds);
+            if (in_fd > max_fd) max_fd = in_fd;
+        }
+        if (out_fd >= 0 && gt_output_pending() > 0) {
+            FD_SET(out_fd, &writefds);
+            if (out_fd > max_fd) max_fd = out_fd;
+        }
+        struct timeval tv = { wait / 1000, (wait % 1000) * 1000 };
+        if (select(max_fd + 1, &readfds, &writefds, NULL, &tv) < 0 && errno != EINTR) break;
+
+        for (int i = 0; i < RECV_BATCH; i++) {
+            eclib_err_t ret = eclib_shim_recv(msg, MESSAGE_SIZE);
+            if (ret == ECLIB_IPC_MSG_NOT_FOUND) break;
+            if (ret != ECLIB_OK || !handle_message(&wm, msg)) {
+                wm.rejected++;
+                continue;
+            }
+            wm.bytes += msg->payload_size;
+        }
+        composite(&wm);
+
+        // Renders a due frame, drains output and reads the keys typed
+        gt_event_t event;
+        int ret;
+        while ((ret = gt_wait_event(&event, 0)) == 0) route_event(&wm, &event);
+        if (ret < 0 && !headless) break;
+    }
+
+    gt_stats_t stats;
+    gt_get_stats(&stats);
+    double elapsed = (double)(gt_now_ns() - start_ns) / 1e9;
+    eclib_service_unregister("window_manager");
+    while (wm.windows) destroy_window(&wm, wm.windows);
+    gt_destroy_window(wm.desktop);
+    gt_cleanup();
+    if (context) gt_destroy_context(context);
+
+    static const char *names[] = {
+        "create", "destroy", "draw_char", "draw_string", "draw_border",
+        "clear", "refresh", "event_key", "event_mouse", "draw_cells"
+    };
+    uint64_t total = 0;
+    for (int i = 0; i <= GT_IPC_DRAW_CELLS; i++) total += wm.messages[i];
+    fprintf(stderr, "wm_service: %.1f s, %llu messages (%.0f/s), %llu bytes, %llu rejected\n",
+            elapsed, (unsigned long long)total, elapsed > 0 ? (double)total / elapsed : 0.0,
+            (unsigned long long)wm.bytes, (unsigned long long)wm.rejected);
+    for (int i = 0; i <= GT_IPC_DRAW_CELLS; i++) {
+        if (wm.messages[i]) fprintf(stderr, "  %-12s %llu\n", names[i], (unsigned long long)wm.messages[i]);
+    }
+    fprintf(stderr, "  %llu cells composited, %llu frames, %llu bytes to the terminal, %llu keys routed, %llu clients reaped\n",
+            (unsigned long long)wm.composited, (unsigned long long)stats.frames_rendered,
+            (unsigned long long)stats.bytes_written, (unsigned long long)wm.keys_routed,
+            (unsigned long long)wm.clients_reaped);
+
+    free(msg);
+    free(wm.span);
+    free(wm.row);
+    free(wm.damage_x0);
+    free(wm.damage_x1);
+    return 0;
+}
@@ -0,0 +1,231 @@
+/*
+    GTLib - Terminal text GUI Library of E-comOS
+    Copyright (C) 2025  Saladin5101
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * wmload - load a running wm_service with many GTlib clients
+ *
+ *   wmload [-c clients] [-t seconds] [-f fps]
+ *
+ * Forks the clients (50 by default). Each one creates a window and, at
+ * the given rate, redraws the rows that changed and refreshes it, through
+ * the same IPC send pipeline as any GTlib client; a client whose messages
+ * are still queued skips the frame. Keys routed to a window are counted.
+ * The totals over all clients are printed at the end.
+ */
+#include "gtlib.h"
+#include "eclib_shim.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define WINDOW_WIDTH 24
+#define WINDOW_HEIGHT 6
+#define PENDING_MAX 8               // queued messages before a frame is skipped
+
+struct result {
+    uint64_t frames, skipped, keys;
+    uint64_t sent, bytes, coalesced, retried, errors;
+    bool connected;
+};
+
+static void sleep_ms(int ms) {
+    struct timespec ts = { ms / 1000, (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static void put_text(gt_cell_t *row, int x, const char *text, gt_color_t fg) {
+    for (int i = 0; text[i] && x + i < WINDOW_WIDTH - 1; i++) {
+        row[x + i] = (gt_cell_t){ text[i], (uint8_t)fg, GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+    }
+}
+
+static void draw_frame(gt_cell_t *cells, int client, uint64_t frame) {
+    gt_cell_t *row = &cells[2 * WINDOW_WIDTH];
+    char text[32];
+    snprintf(text, sizeof(text), "frame %llu", (unsigned long long)frame);
+    for (int x = 1; x < WINDOW_WIDTH - 1; x++) row[x] = (gt_cell_t){ ' ', GT_COLOR_DEFAULT, GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+    put_text(row, 2, text, GT_COLOR_WHITE);
+
+    // A bar that sweeps across the window
+    row = &cells[3 * WINDOW_WIDTH];
+    int fill = (int)((frame + (uint64_t)client) % (WINDOW_WIDTH - 2));
+    for (int x = 1; x < WINDOW_WIDTH - 1; x++) {
+        row[x] = (gt_cell_t){ x <= fill ? '#' : ' ', GT_COLOR_GREEN, GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+    }
+}
+
+static void init_window(gt_cell_t *cells, int client) {
+    for (int y = 0; y < WINDOW_HEIGHT; y++) {
+        for (int x = 0; x < WINDOW_WIDTH; x++) {
+            bool edge_x = x == 0 || x == WINDOW_WIDTH - 1;
+            bool edge_y = y == 0 || y == WINDOW_HEIGHT - 1;
+            char ch = edge_x && edge_y ? '+' : edge_x ? '|' : edge_y ? '-' : ' ';
+            cells[y * WINDOW_WIDTH + x] = (gt_cell_t){ ch, GT_COLOR_CYAN, GT_COLOR_DEFAULT, GT_ATTR_NORMAL };
+        }
+    }
+    char title[32];
+    snprintf(title, sizeof(title), " client %d ", client);
+    put_text(cells, 2, title, GT_COLOR_YELLOW);
+}
+
+static void run_client(int client, int clients, double seconds, int fps, struct result *result) {
+    // The service may still be starting
+    for (int tries = 0; gt_ipc_connect_wm() != 0; tries++) {
+        if (tries == 100) return;
+        sleep_ms(20);
+    }
+    result->connected = true;
+
+    // Cascade the windows over the screen
+    int columns = 80 - WINDOW_WIDTH;
+    int rows = 23 - WINDOW_HEIGHT;
+    uint8_t create[sizeof(struct gt_ipc_geometry) + 32];
+    struct gt_ipc_geometry geometry = {
+        (client * 7) % columns, (client * 3 + client / 8) % rows, WINDOW_WIDTH, WINDOW_HEIGHT
+    };
+    memcpy(create, &geometry, sizeof(geometry));
+    int title_len = snprintf((char *)create + sizeof(geometry), 32, "client %d of %d", client, clients);
+    uint32_t id = 1;
+    gt_ipc_send_msg(GT_IPC_CREATE_WINDOW, id, create, (uint32_t)(sizeof(geometry) + (size_t)title_len));
+
+    gt_cell_t cells[WINDOW_WIDTH * WINDOW_HEIGHT];
+    init_window(cells, client);
+    gt_ipc_send_cells(id, 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, cells, WINDOW_WIDTH);
+    gt_ipc_send_msg(GT_IPC_REFRESH_WINDOW, id, NULL, 0);
+
+    ipc_message_t *msg = malloc(sizeof(ipc_message_t) + ECLIB_SHIM_PAYLOAD_MAX);
+    uint64_t interval_ns = 1000000000ull / (uint64_t)fps;
+    uint64_t end_ns = gt_now_ns() + (uint64_t)(seconds * 1e9);
+    uint64_t next_ns = gt_now_ns();
+    uint64_t frame = 0;
+
+    while (gt_now_ns() < end_ns) {
+        while (msg && eclib_shim_recv(msg, sizeof(ipc_message_t) + ECLIB_SHIM_PAYLOAD_MAX) == ECLIB_OK) {
+            if (msg->message_id == GT_IPC_EVENT_KEY) result->keys++;
+        }
+
+        if (gt_ipc_pending() > PENDING_MAX) {
+            gt_ipc_flush();
+            result->skipped++;
+        } else {
+            draw_frame(cells, client, ++frame);
+            gt_ipc_send_cells(id, 1, 2, WINDOW_WIDTH - 2, 2, &cells[2 * WINDOW_WIDTH + 1], WINDOW_WIDTH);
+            gt_ipc_send_msg(GT_IPC_REFRESH_WINDOW, id, NULL, 0);
+            result->frames++;
+        }
+
+        next_ns += interval_ns;
+        uint64_t now = gt_now_ns();
+        if (next_ns > now) {
+            sleep_ms((int)((next_ns - now) / 1000000));
+        } else {
+            next_ns = now;
+        }
+    }
+
+    gt_ipc_send_msg(GT_IPC_DESTROY_WINDOW, id, NULL, 0);
+    for (int tries = 0; gt_ipc_pending() > 0 && tries < 100; tries++) {
+        if (gt_ipc_flush() != 0) break;
+        sleep_ms(10);
+    }
+    free(msg);
+
+    gt_stats_t stats;
+    gt_get_stats(&stats);
+    result->sent = stats.ipc_messages_sent;
+    result->bytes = stats.ipc_bytes_sent;
+    result->coalesced = stats.ipc_messages_coalesced;
+    result->retried = stats.ipc_messages_retried;
+    result->errors = stats.ipc_send_errors;
+}
+
+int main(int argc, char **argv) {
+    int clients = 50, fps = 30;
+    double seconds = 5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            clients = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            fps = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [-c clients] [-t seconds] [-f fps]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (clients <= 0 || fps <= 0 || seconds <= 0) {
+        fprintf(stderr, "wmload: clients, seconds and fps must be positive\n");
+        return 2;
+    }
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("wmload: pipe");
+        return 1;
+    }
+    for (int client = 0; client < clients; client++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("wmload: fork");
+            clients = client;
+            break;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            struct result result;
+            memset(&result, 0, sizeof(result));
+            run_client(client, clients, seconds, fps, &result);
+            ssize_t n = write(fds[1], &result, sizeof(result));
+            // exit(), not _exit(), so the shim removes the client's socket
+            exit(n == (ssize_t)sizeof(result) ? 0 : 1);
+        }
+    }
+    close(fds[1]);
+
+    struct result total;
+    memset(&total, 0, sizeof(total));
+    int connected = 0, reported = 0;
+    struct result result;
+    while (read(fds[0], &result, sizeof(result)) == (ssize_t)sizeof(result)) {
+        reported++;
+        connected += result.connected;
+        total.frames += result.frames;
+        total.skipped += result.skipped;
+        total.keys += result.keys;
+        total.sent += result.sent;
+        total.bytes += result.bytes;
+        total.coalesced += result.coalesced;
+        total.retried += result.retried;
+        total.errors += result.errors;
+    }
+    while (wait(NULL) > 0 || errno == EINTR) {}
+
+    printf("wmload: %d clients, %d connected, %d reported\n", clients, connected, reported);
+    printf("  %llu frames (%.0f/s), %llu skipped while queued\n",
+           (unsigned long long)total.frames, (double)total.frames / seconds, (unsigned long long)total.skipped);
+    printf("  %llu messages sent, %llu bytes, %llu coalesced, %llu retried, %llu errors\n",
+           (unsigned long long)total.sent, (unsigned long long)total.bytes, (unsigned long long)total.coalesced,
+           (unsigned long long)total.retried, (unsigned long long)total.errors);
+    printf("  %llu keys received\n", (unsigned long long)total.keys);
+    return connected == clients ? 0 : 1;
+}